@@ -0,0 +1,73 @@
+#include "AbstractDataSource.h"
+#include "ImpedanceEstimator.h"
+
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+// Live-Impedanz wird mit 4 Hz an die GUI gemeldet
+constexpr double kImpedanceUpdateHz = 4.0;
+} // namespace
+
+AbstractDataSource::~AbstractDataSource() { delete m_impedanceEstimator; }
+
+void AbstractDataSource::setLeadOffExcitation(bool on) {
+  sendCommand(on ? "LOFF 1" : "LOFF 0");
+  // Aus wirkt sofort, an erst mit der Antwort "LOFF:1"
+  if (!on)
+    confirmLeadOff(false);
+}
+
+void AbstractDataSource::confirmLeadOff(bool on) {
+  if (on == m_leadOffEnabled)
+    return;
+  m_leadOffEnabled = on;
+
+  if (!on) {
+    delete m_impedanceEstimator;
+    m_impedanceEstimator = nullptr;
+    return;
+  }
+
+  // Schätzer entsteht mit dem ersten Frame (Kanalzahl der Quelle)
+  if (m_impedanceEstimator)
+    m_impedanceEstimator->reset();
+  m_impedanceCountdown = 0;
+  emit statusMessage(tr("Lead-off excitation active."));
+}
+
+bool AbstractDataSource::handleResponse(const QByteArray &data) {
+  if (!data.startsWith("IMP:") && !data.startsWith("LOFF:"))
+    return false;
+
+  const QString text = QString::fromUtf8(data).trimmed();
+  if (text.startsWith("IMP:")) {
+    emit impedanceReceived(text.mid(4).split(',')); // ohne "IMP:"
+  } else {
+    confirmLeadOff(text.mid(5).trimmed() == "1");
+  }
+  return true;
+}
+
+void AbstractDataSource::publishSample(const QVector<double> &values) {
+  if (m_leadOffEnabled) {
+    const double fs = sampleRate();
+    const int channels = int(values.size());
+    if (m_impedanceEstimator &&
+        m_impedanceEstimator->channelCount() != channels) {
+      delete m_impedanceEstimator;
+      m_impedanceEstimator = nullptr;
+    }
+    if (!m_impedanceEstimator)
+      m_impedanceEstimator = new ImpedanceEstimator(channels, fs);
+    m_impedanceEstimator->updateSampleRate(fs);
+    m_impedanceEstimator->processFrame(values);
+
+    if (m_impedanceEstimator->isReady() && --m_impedanceCountdown <= 0) {
+      m_impedanceCountdown = std::max(1, int(fs / kImpedanceUpdateHz));
+      emit impedanceUpdated(m_impedanceEstimator->impedancesKOhm());
+    }
+  }
+
+  emit newEEGData(values);
+}
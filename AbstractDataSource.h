@@ -4,11 +4,25 @@
 #include <QObject>
 #include <QVector>
 
+class ImpedanceEstimator;
+
+/**
+ * Gemeinsame Schnittstelle der Datenquellen (Simulation, UDP, BLE, Datei).
+ *
+ * Gerätebefehle (sendCommand, je eine Textzeile mit "\n"):
+ *   SPS <rate>, GAIN ALL <gain>, BIAS <0|1>, SRB2 <0|1>, TEST <0|1>
+ *   IMPEDANCE    einmalige Messung, Antwort "IMP:<z1>,<z2>,..."
+ *   LOFF <0|1>   AC-Lead-Off-Anregung des ADS1299 (31.25 Hz) dauerhaft an
+ *                bzw. aus, Antwort "LOFF:<0|1>". Ohne Antwort (Firmware
+ *                ohne LOFF) bleibt die Live-Impedanz aus.
+ * Antworten kommen als Textzeilen im Datenstrom und gehen durch
+ * handleResponse().
+ */
 class AbstractDataSource : public QObject {
   Q_OBJECT
 public:
   using QObject::QObject;
-  ~AbstractDataSource() override = default;
+  ~AbstractDataSource() override;
 
   virtual void start() = 0;
   virtual void stop() = 0;
@@ -18,10 +32,32 @@ public:
   virtual void sendCommand(const QString &cmd) { Q_UNUSED(cmd); }
   virtual bool isConnected() const { return false; }
 
+  // AC-Lead-Off-Anregung für die kontinuierliche Impedanzmessung (LOFF);
+  // aktiv erst nach der Bestätigung des Geräts
+  virtual void setLeadOffExcitation(bool on);
+  bool leadOffExcitationEnabled() const { return m_leadOffEnabled; }
+
 signals:
   void newEEGData(const QVector<double> &values);
   void statusMessage(const QString &msg);
   void impedanceReceived(const QStringList &values);
+  void impedanceUpdated(const QVector<double> &kOhm);
+
+protected:
+  // Rohsample weiterreichen: speist bei aktiver Lead-Off-Anregung die
+  // Impedanzschätzung (vor jeglicher Filterung) und emittiert newEEGData.
+  void publishSample(const QVector<double> &values);
+
+  // Textantwort der Firmware ("IMP:...", "LOFF:..."); false, wenn die Daten
+  // keine Antwort sind
+  bool handleResponse(const QByteArray &data);
+  // Anregung bestätigt (bzw. aus): startet/beendet die Impedanzschätzung
+  void confirmLeadOff(bool on);
+
+private:
+  ImpedanceEstimator *m_impedanceEstimator = nullptr; // Kanäle wie die Frames
+  bool m_leadOffEnabled = false;
+  int m_impedanceCountdown = 0;
 };
 
 #endif // ABSTRACTDATASOURCE_H
@@ -0,0 +1,106 @@
+#include "BandPowerMatrix.h"
+#include "WelchEstimator.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+BandPowerMatrix::BandPowerMatrix(int numChannels)
+    : m_numChannels(std::max(0, numChannels)),
+      m_bands(BandPowerTracker::defaultBands()) {
+  reset();
+}
+
+void BandPowerMatrix::setBands(const QVector<Band> &bands) {
+  m_bands = bands;
+  m_mappedBins = 0; // Zuordnung beim nächsten update() neu aufbauen
+  reset();
+}
+
+void BandPowerMatrix::reset() {
+  m_power.fill(0.0, m_numChannels * m_bands.size());
+  m_valid = false;
+}
+
+void BandPowerMatrix::mapBins(int bins, double binHz) {
+  // Bin k liegt bei f = k * binHz und zählt zum Band mit low <= f < high
+  auto firstBinAt = [&](double hz) {
+    return qBound(0, int(std::ceil(hz / binHz)), bins);
+  };
+  m_binLo.resize(m_bands.size());
+  m_binHi.resize(m_bands.size());
+  for (int b = 0; b < m_bands.size(); ++b) {
+    m_binLo[b] = firstBinAt(m_bands[b].lowHz);
+    m_binHi[b] = std::max(m_binLo[b], firstBinAt(m_bands[b].highHz));
+  }
+  m_mappedBins = bins;
+  m_mappedBinHz = binHz;
+}
+
+bool BandPowerMatrix::update(const WelchEstimator &estimator) {
+  const int B = m_bands.size();
+  const int channels = std::min(m_numChannels, estimator.channels());
+  if (channels == 0 || B == 0 || !estimator.isReady())
+    return false;
+
+  const double binHz = estimator.binHz();
+  const int bins = estimator.bins();
+  if (bins != m_mappedBins || binHz != m_mappedBinHz)
+    mapBins(bins, binHz);
+
+  for (int ch = 0; ch < channels; ++ch) {
+    double *row = m_power.data() + ch * B;
+    const double *p = estimator.psdData(ch);
+    for (int b = 0; b < B; ++b) {
+      double sum = 0.0;
+      for (int k = m_binLo[b]; k < m_binHi[b]; ++k)
+        sum += p[k];
+      row[b] = sum * binHz; // µV²
+    }
+  }
+
+  m_valid = true;
+  return true;
+}
+
+double BandPowerMatrix::power(int channel, int band) const {
+  if (channel < 0 || channel >= m_numChannels || band < 0 ||
+      band >= m_bands.size())
+    return 0.0;
+  return m_power[channel * m_bands.size() + band];
+}
+
+QVector<double> BandPowerMatrix::channelPowers(int channel) const {
+  const int B = m_bands.size();
+  QVector<double> p(B, 0.0);
+  if (channel >= 0) {
+    for (int b = 0; b < B; ++b)
+      p[b] = power(channel, b);
+    return p;
+  }
+
+  if (m_numChannels == 0)
+    return p;
+  for (int ch = 0; ch < m_numChannels; ++ch)
+    for (int b = 0; b < B; ++b)
+      p[b] += m_power[ch * B + b];
+  for (double &v : p)
+    v /= double(m_numChannels);
+  return p;
+}
+
+QVector<double> BandPowerMatrix::bandTopography(int band) const {
+  QVector<double> t(m_numChannels, 0.0);
+  for (int ch = 0; ch < m_numChannels; ++ch)
+    t[ch] = power(ch, band);
+  return t;
+}
+
+QVector<double> BandPowerMatrix::totalPowers() const {
+  const int B = m_bands.size();
+  QVector<double> t(m_numChannels, 0.0);
+  for (int ch = 0; ch < m_numChannels; ++ch)
+    for (int b = 0; b < B; ++b)
+      t[ch] += m_power[ch * B + b];
+  return t;
+}
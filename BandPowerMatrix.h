@@ -0,0 +1,63 @@
+#ifndef BANDPOWERMATRIX_H
+#define BANDPOWERMATRIX_H
+
+#include "BandPowerTracker.h"
+
+#include <QVector>
+
+class WelchEstimator;
+
+/**
+ * Bandleistungs-Matrix Kanäle x Bänder aus den Welch-Spektren der Kanäle.
+ *
+ * Die PSDs liegen für den FFT-Plot ohnehin vor; hier wird pro Kanal nur
+ * noch einmal über die Bins der Bänder gelaufen, die Bin-Bereiche je Band
+ * sind vorberechnet. Kein eigener FFT-Durchlauf, kein
+ * separater Mittelwert-Kanal. Das Kanalmittel und die Topographie je Band
+ * werden aus der Matrix abgeleitet.
+ */
+class BandPowerMatrix
+{
+public:
+    using Band = BandPowerTracker::Band;
+
+    explicit BandPowerMatrix(int numChannels);
+
+    void setBands(const QVector<Band> &bands);
+    const QVector<Band> &bands() const { return m_bands; }
+    int bandCount() const { return m_bands.size(); }
+    int channelCount() const { return m_numChannels; }
+
+    /// Matrix aus den aktuellen PSDs eines Mehrkanal-Schätzers neu
+    /// berechnen; false, solange er noch nicht bereit ist
+    bool update(const WelchEstimator &estimator);
+
+    void reset();
+    bool isValid() const { return m_valid; }
+
+    /// Bandleistung (µV²) eines Kanals
+    double power(int channel, int band) const;
+    /// Alle Bänder eines Kanals, ch = -1 -> Mittel über alle Kanäle
+    QVector<double> channelPowers(int channel) const;
+    /// Ein Band über alle Kanäle (für Topomaps)
+    QVector<double> bandTopography(int band) const;
+    /// Summe aller Bänder je Kanal
+    QVector<double> totalPowers() const;
+
+private:
+    void mapBins(int bins, double binHz);
+
+    int m_numChannels = 0;
+    QVector<Band> m_bands;
+
+    // Bin-Bereich [lo, hi) je Band; jeder Bin gehört zu höchstens einem Band
+    QVector<int> m_binLo;
+    QVector<int> m_binHi;
+    int    m_mappedBins  = 0;
+    double m_mappedBinHz = 0.0;
+
+    QVector<double> m_power;   // [channel * bands + band]
+    bool m_valid = false;
+};
+
+#endif // BANDPOWERMATRIX_H
@@ -0,0 +1,183 @@
+#include "BandPowerTracker.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+// Polradius knapp unter 1: Rundungsfehler der Rotation klingen ab
+constexpr double kDamping = 1.0 - 1e-7;
+} // namespace
+
+QVector<BandPowerTracker::Band> BandPowerTracker::defaultBands() {
+  return {{"delta", 0.5, 4.0},
+          {"theta", 4.0, 8.0},
+          {"alpha", 8.0, 13.0},
+          {"beta", 13.0, 32.0},
+          {"gamma", 32.0, 100.0}};
+}
+
+BandPowerTracker::BandPowerTracker(int numChannels, double sampleRate,
+                                   double windowSec)
+    : m_numChannels(numChannels), m_sampleRate(sampleRate),
+      m_windowSec(windowSec), m_bands(defaultBands()) {
+  design();
+}
+
+void BandPowerTracker::setBands(const QVector<Band> &bands) {
+  m_bands = bands;
+  design();
+}
+
+int BandPowerTracker::bandIndex(const QString &name) const {
+  for (int i = 0; i < m_bands.size(); ++i)
+    if (m_bands[i].name == name)
+      return i;
+  return -1;
+}
+
+void BandPowerTracker::updateSampleRate(double fs) {
+  if (fs <= 0.0 || fs == m_sampleRate)
+    return;
+  m_sampleRate = fs;
+  design();
+}
+
+void BandPowerTracker::setWindowSeconds(double sec) {
+  if (sec <= 0.0 || sec == m_windowSec)
+    return;
+  m_windowSec = sec;
+  design();
+}
+
+void BandPowerTracker::design() {
+  m_windowLength = 0;
+  m_binCount = 0;
+  m_bandLo.clear();
+  m_bandHi.clear();
+
+  if (m_numChannels <= 0 || m_sampleRate <= 0.0 || m_bands.isEmpty())
+    return;
+
+  const int N = std::max(8, qRound(m_sampleRate * m_windowSec));
+  const double df = m_sampleRate / double(N);
+  const int maxBin = N / 2 - 1;
+
+  // Bins [low, high) je Band, plus je ein Nachbarbin für das Hann-Fenster
+  int lo = maxBin, hi = 1;
+  for (const Band &b : std::as_const(m_bands)) {
+    int bLo = qBound(1, int(std::ceil(b.lowHz / df)), maxBin);
+    int bHi = qBound(bLo, int(std::ceil(b.highHz / df)) - 1, maxBin);
+    m_bandLo.append(bLo);
+    m_bandHi.append(bHi);
+    lo = std::min(lo, bLo);
+    hi = std::max(hi, bHi);
+  }
+
+  m_windowLength = N;
+  m_firstBin = lo - 1;
+  m_binCount = (hi + 1) - m_firstBin + 1;
+
+  m_cos.resize(m_binCount);
+  m_sin.resize(m_binCount);
+  for (int b = 0; b < m_binCount; ++b) {
+    double w = 2.0 * M_PI * double(m_firstBin + b) / double(N);
+    m_cos[b] = kDamping * std::cos(w);
+    m_sin[b] = kDamping * std::sin(w);
+  }
+  m_rN = std::pow(kDamping, N);
+
+  // Hann: sum(w^2) = 3N/8; einseitig (x2), Bandleistung = sum PSD * df
+  m_powerScale = 16.0 / (3.0 * double(N) * double(N));
+
+  m_re.resize(m_numChannels * m_binCount);
+  m_im.resize(m_numChannels * m_binCount);
+  m_delay.resize(m_numChannels * N);
+  reset();
+}
+
+void BandPowerTracker::reset() {
+  m_re.fill(0.0);
+  m_im.fill(0.0);
+  m_delay.fill(0.0);
+  m_pos = 0;
+  m_filled = 0;
+}
+
+void BandPowerTracker::processBlock(const double *interleaved, int frames,
+                                    int stride) {
+  const int N = m_windowLength;
+  if (N <= 0)
+    return;
+
+  const int channels = std::min(m_numChannels, stride);
+  const int B = m_binCount;
+  const double *c = m_cos.constData();
+  const double *s = m_sin.constData();
+
+  for (int f = 0; f < frames; ++f) {
+    const double *frame = interleaved + f * stride;
+    for (int ch = 0; ch < channels; ++ch) {
+      double &old = m_delay[ch * N + m_pos];
+      const double d = frame[ch] - m_rN * old;
+      old = frame[ch];
+
+      double *re = m_re.data() + ch * B;
+      double *im = m_im.data() + ch * B;
+      for (int b = 0; b < B; ++b) {
+        const double a = re[b] + d;
+        const double i = im[b];
+        re[b] = a * c[b] - i * s[b];
+        im[b] = a * s[b] + i * c[b];
+      }
+    }
+
+    if (++m_pos >= N)
+      m_pos = 0;
+    if (m_filled < N)
+      ++m_filled;
+  }
+}
+
+double BandPowerTracker::channelBandPower(int channel, int band) const {
+  const int B = m_binCount;
+  const double *re = m_re.constData() + channel * B;
+  const double *im = m_im.constData() + channel * B;
+
+  double sum = 0.0;
+  for (int k = m_bandLo[band]; k <= m_bandHi[band]; ++k) {
+    const int b = k - m_firstBin;
+    const double hr = 0.5 * re[b] - 0.25 * (re[b - 1] + re[b + 1]);
+    const double hi = 0.5 * im[b] - 0.25 * (im[b - 1] + im[b + 1]);
+    sum += hr * hr + hi * hi;
+  }
+  return sum * m_powerScale;
+}
+
+double BandPowerTracker::bandPower(int channel, int band) const {
+  if (m_windowLength <= 0 || band < 0 || band >= m_bandLo.size() ||
+      channel >= m_numChannels)
+    return 0.0;
+
+  if (channel >= 0)
+    return channelBandPower(channel, band);
+
+  double sum = 0.0;
+  for (int ch = 0; ch < m_numChannels; ++ch)
+    sum += channelBandPower(ch, band);
+  return sum / double(m_numChannels);
+}
+
+QVector<double> BandPowerTracker::bandPowers(int channel) const {
+  QVector<double> p(m_bands.size());
+  for (int b = 0; b < m_bands.size(); ++b)
+    p[b] = bandPower(channel, b);
+  return p;
+}
+
+double BandPowerTracker::ratio(int numeratorBand, int denominatorBand,
+                               int channel) const {
+  const double den = bandPower(channel, denominatorBand);
+  return (den > 1e-12) ? bandPower(channel, numeratorBand) / den : 0.0;
+}
@@ -0,0 +1,85 @@
+#ifndef BANDPOWERTRACKER_H
+#define BANDPOWERTRACKER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * Bandleistung pro Kanal mit Sliding-DFT für Neurofeedback.
+ *
+ * Für jedes Band werden die DFT-Bins eines gleitenden Fensters (Länge
+ * windowSec) rekursiv nachgeführt: S_k(n) = e^{jw_k} (S_k(n-1) + x[n] - x[n-N]).
+ * Kosten O(Bins) pro Sample, das Ergebnis ist nach jedem Sample aktuell.
+ * Die Hann-Fensterung passiert im Frequenzbereich (0.5 S_k - 0.25 (S_k-1 + S_k+1)),
+ * daher werden die Nachbarbins am Rand mitgeführt.
+ */
+class BandPowerTracker
+{
+public:
+    struct Band {
+        QString name;
+        double  lowHz  = 0.0;
+        double  highHz = 0.0;
+    };
+
+    /// Delta .. Gamma wie im Bandpower-Plot
+    static QVector<Band> defaultBands();
+
+    BandPowerTracker(int numChannels,
+                     double sampleRate,
+                     double windowSec = 1.0);
+
+    void setBands(const QVector<Band> &bands);
+    const QVector<Band> &bands() const { return m_bands; }
+    int bandIndex(const QString &name) const;
+
+    void updateSampleRate(double fs);
+    void setWindowSeconds(double sec);
+    double windowSeconds() const { return m_windowSec; }
+    double binHz() const { return m_windowLength > 0 ? m_sampleRate / m_windowLength : 0.0; }
+
+    void reset();
+
+    /// frames Frames aus einem interleavten Block (stride = Kanäle im Block)
+    void processBlock(const double *interleaved, int frames, int stride);
+
+    /// true, sobald ein komplettes Fenster eingelaufen ist
+    bool isReady() const { return m_filled >= m_windowLength; }
+
+    /// Bandleistung (µV²) eines Kanals, ch = -1 -> Mittel über alle Kanäle
+    double bandPower(int channel, int band) const;
+    QVector<double> bandPowers(int channel) const;
+
+    /// Verhältnis zweier Bänder, ch = -1 -> aus den Kanalmitteln
+    double ratio(int numeratorBand, int denominatorBand, int channel = -1) const;
+
+    int binCount() const { return m_binCount; }
+
+private:
+    void design();
+    double channelBandPower(int channel, int band) const;
+
+    int    m_numChannels  = 0;
+    double m_sampleRate   = 250.0;
+    double m_windowSec    = 1.0;
+    QVector<Band> m_bands;
+
+    int    m_windowLength = 0;   // N
+    int    m_firstBin     = 0;   // kleinster mitgeführter Bin
+    int    m_binCount     = 0;
+    double m_rN           = 1.0; // r^N
+    double m_powerScale   = 0.0; // |X_hann|^2 -> µV² (inkl. einseitig)
+
+    QVector<double> m_cos;       // r cos(w_k) je Bin
+    QVector<double> m_sin;       // r sin(w_k) je Bin
+    QVector<int>    m_bandLo;    // erster Bin je Band (absolut)
+    QVector<int>    m_bandHi;    // letzter Bin je Band (absolut, inkl.)
+
+    QVector<double> m_re;        // [channel * binCount + b]
+    QVector<double> m_im;
+    QVector<double> m_delay;     // [channel * N + pos]
+    int             m_pos    = 0;
+    int             m_filled = 0;
+};
+
+#endif // BANDPOWERTRACKER_H
@@ -0,0 +1,11 @@
+#include "Benchmarks.h"
+
+#include <QApplication>
+
+// Konsolenprogramm NeuroEase_bench (ohne Hauptfenster); Exit-Code != 0,
+// wenn eine Plausibilitätsprüfung fehlschlägt
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+    return Benchmarks::runAll();
+}
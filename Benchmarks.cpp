@@ -0,0 +1,1233 @@
+#include "Benchmarks.h"
+#include "BandPowerMatrix.h"
+#include "ChirpZ.h"
+#include "ConnectivityEstimator.h"
+#include "EegMontageView.h"
+#include "FftPlan.h"
+#include "MinMaxEnvelope.h"
+#include "RunningRms.h"
+#include "SampleHistory.h"
+#include "SlidingRange.h"
+#include "SpectralCache.h"
+#include "StreamingGraph.h"
+#include "TopoHeatmap.h"
+#include "WelchEstimator.h"
+#include "electrodemap.h"
+#include "qcustomplot.h"
+
+#include <QElapsedTimer>
+#include <QGraphicsEllipseItem>
+#include <QGraphicsPixmapItem>
+#include <QGraphicsScene>
+#include <QGraphicsSimpleTextItem>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <utility>
+
+namespace {
+
+QTextStream &out() {
+  static QTextStream stream(stdout);
+  return stream;
+}
+
+QVector<double> randomSignal(int n) {
+  QVector<double> x(n);
+  for (double &v : x)
+    v = QRandomGenerator::global()->generateDouble() * 200.0 - 100.0;
+  return x;
+}
+
+// Wiederholt f(), bis mindestens ~100 ms vergangen sind; liefert µs/Aufruf
+template <typename F> double timeIt(F &&f) {
+  QElapsedTimer timer;
+  int reps = 0;
+  timer.start();
+  do {
+    f();
+    ++reps;
+  } while (timer.nsecsElapsed() < 100000000LL);
+  return double(timer.nsecsElapsed()) / 1000.0 / reps;
+}
+
+// Plausibilitätsprüfungen neben den Zeiten; bestimmen den Exit-Code
+int failedChecks = 0;
+
+void check(bool ok, const QString &what) {
+  if (ok)
+    return;
+  ++failedChecks;
+  out() << "CHECK FAILED: " << what << "\n";
+}
+
+// --- Referenz: bisherige MainWindow::fft + computeMagnitudeSpectrum ---------
+
+void legacyFft(QVector<std::complex<double>> &a, bool invert) {
+  int n = a.size();
+  for (int i = 1, j = 0; i < n; i++) {
+    int bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      std::swap(a[i], a[j]);
+  }
+  for (int len = 2; len <= n; len <<= 1) {
+    double ang = 2 * M_PI / len * (invert ? -1 : 1);
+    std::complex<double> wlen(std::cos(ang), std::sin(ang));
+    for (int i = 0; i < n; i += len) {
+      std::complex<double> w(1);
+      for (int j = 0; j < len / 2; j++) {
+        std::complex<double> u = a[i + j], v = a[i + j + len / 2] * w;
+        a[i + j] = u + v;
+        a[i + j + len / 2] = u - v;
+        w *= wlen;
+      }
+    }
+  }
+  if (invert) {
+    for (auto &x : a)
+      x /= n;
+  }
+}
+
+QVector<double> legacyMagnitude(const QVector<double> &signal, int N) {
+  QVector<std::complex<double>> fa(N);
+  for (int i = 0; i < N; i++) {
+    double w = 0.5 * (1.0 - std::cos(2.0 * M_PI * i / (N - 1)));
+    fa[i] = std::complex<double>(signal[i] * w, 0);
+  }
+  legacyFft(fa, false);
+  QVector<double> mag(N / 2);
+  for (int k = 0; k < N / 2; ++k)
+    mag[k] = std::abs(fa[k]) / double(N);
+  return mag;
+}
+
+// --- Referenz: bisherige ElectrodeMap::drawHeatmap --------------------------
+
+QImage legacyHeatmap(const QVector<QPointF> &positions,
+                     const QVector<double> &activities) {
+  double headR = 80;
+  QImage heatmap(300, 300, QImage::Format_ARGB32);
+  heatmap.fill(Qt::transparent);
+  for (int y = 0; y < 300; ++y) {
+    double py = double(y) - 150.0;
+    for (int x = 0; x < 300; ++x) {
+      double px = double(x) - 150.0;
+      double e = (px * px) / (headR * headR) +
+                 (py * py) / ((1.1 * headR) * (1.1 * headR));
+      if (e > 1.0)
+        continue;
+      double sumW = 0.0;
+      double sumA = 0.0;
+      for (int i = 0; i < activities.size() && i < positions.size(); ++i) {
+        double dx = px - positions[i].x();
+        double dy = py - positions[i].y();
+        double d = qSqrt(dx * dx + dy * dy) + 0.01;
+        double w = 1.0 / (d * d);
+        sumW += w;
+        sumA += w * activities[i];
+      }
+      double val = qBound(0.0, sumW > 0.0 ? sumA / sumW : 0.0, 1.0);
+      heatmap.setPixelColor(x, y, QColor(int(255 * val),
+                                         int(255 * (1.0 - val)), 0, 140));
+    }
+  }
+  return heatmap;
+}
+
+// --- Referenz: bisheriges ElectrodeMap::setActivities (clear + Neuaufbau) ----
+
+void legacyRebuildScene(QGraphicsScene &scene, const QVector<QPointF> &positions,
+                        const QStringList &labels, const QImage &heatmap) {
+  scene.clear();
+  const double headR = 80;
+  QPen pen(Qt::black, 2);
+  scene.addEllipse(-headR, -headR * 1.1, headR * 2, headR * 2.2, pen);
+  scene.addEllipse(-headR - 15, -10, 20, 30, pen);
+  scene.addEllipse(headR - 5, -10, 20, 30, pen);
+  QPainterPath nose;
+  nose.moveTo(0, -headR * 1.1 + 10);
+  nose.lineTo(-10, -headR * 1.1 + 25);
+  nose.lineTo(10, -headR * 1.1 + 25);
+  nose.closeSubpath();
+  scene.addPath(nose, pen);
+
+  QGraphicsPixmapItem *item = scene.addPixmap(QPixmap::fromImage(heatmap));
+  item->setPos(-150, -150);
+  item->setZValue(-1);
+
+  for (int i = 0; i < positions.size(); ++i) {
+    QFont font("Arial");
+    font.setPixelSize(6);
+    font.setBold(true);
+    QGraphicsEllipseItem *el = scene.addEllipse(
+        -7, -7, 14, 14, QPen(Qt::black, 1), QBrush(Qt::gray));
+    el->setPos(positions[i]);
+    el->setZValue(10);
+    auto *text = new QGraphicsSimpleTextItem(labels[i], el);
+    text->setFont(font);
+    text->setZValue(11);
+    const QRectF br = text->boundingRect();
+    text->setPos(-br.width() / 2.0, -br.height() / 2.0);
+  }
+}
+
+} // namespace
+
+namespace Benchmarks {
+
+int runAll() {
+  fftPlan();
+  bandPowerMatrix();
+  fftBatch();
+  sampleHistory();
+  runningRms();
+  spectralCache();
+  chirpZ();
+  connectivity();
+  traceViews();
+  streamingGraph();
+  minMaxEnvelope();
+  montageRendering();
+  topoHeatmap();
+  electrodeMapUpdate();
+  autoscale();
+  if (failedChecks > 0)
+    out() << QString("\n%1 check(s) failed\n").arg(failedChecks);
+  out().flush();
+  return failedChecks > 0 ? 1 : 0;
+}
+
+void fftPlan() {
+  out() << "\n== FFT: FftPlan (real, cached tables) vs. legacy complex radix-2 ==\n";
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg("N", 6)
+               .arg("legacy us", 12)
+               .arg("plan us", 12)
+               .arg("speedup", 9)
+               .arg("max |diff|", 12);
+
+  for (int N = 256; N <= 8192; N *= 2) {
+    const QVector<double> x = randomSignal(N);
+
+    QVector<double> legacy;
+    const double tLegacy = timeIt([&] { legacy = legacyMagnitude(x, N); });
+
+    auto plan = FftPlan::forSize(N);
+    FftWorkspace ws;
+    ws.ensure(N);
+    QVector<double> mag(N / 2);
+    const double tPlan = timeIt([&] {
+      const QVector<double> &win = *FftPlan::hannWindow(N);
+      for (int i = 0; i < N; ++i)
+        ws.input[i] = x[i] * win[i];
+      plan->forwardReal(ws.input.data(), ws.bins.data());
+      for (int k = 0; k < N / 2; ++k)
+        mag[k] = std::abs(ws.bins[k]) / double(N);
+    });
+
+    double maxDiff = 0.0;
+    for (int k = 0; k < N / 2; ++k)
+      maxDiff = std::max(maxDiff, std::abs(mag[k] - legacy[k]));
+
+    out() << QString("%1 %2 %3 %4 %5\n")
+                 .arg(N, 6)
+                 .arg(tLegacy, 12, 'f', 2)
+                 .arg(tPlan, 12, 'f', 2)
+                 .arg(tLegacy / tPlan, 8, 'f', 2)
+                 .arg(maxDiff, 12, 'g', 3);
+    check(maxDiff < 1e-9, QString("FftPlan vs. legacy FFT, N = %1").arg(N));
+  }
+
+  // 3-s-Fenster bei 250..2000 SPS: exakte Länge vs. Padding auf 2er-Potenz
+  out() << "\n== FFT: mixed-radix window length vs. padded power of two ==\n";
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("N", 6)
+               .arg("mixed us", 12)
+               .arg("pow2 N", 8)
+               .arg("pow2 us", 12);
+
+  for (int N : {750, 1500, 3000, 6000}) {
+    int P = 4;
+    while (P < N)
+      P <<= 1;
+
+    double t[2] = {0.0, 0.0};
+    const int sizes[2] = {N, P};
+    for (int i = 0; i < 2; ++i) {
+      const int n = sizes[i];
+      const QVector<double> x = randomSignal(n);
+      auto plan = FftPlan::forSize(n);
+      FftWorkspace ws;
+      ws.ensure(n);
+      t[i] = timeIt([&] { plan->forwardReal(x.constData(), ws.bins.data()); });
+    }
+
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(N, 6)
+                 .arg(t[0], 12, 'f', 2)
+                 .arg(P, 8)
+                 .arg(t[1], 12, 'f', 2);
+  }
+}
+
+void bandPowerMatrix() {
+  out() << "\n== Band power: channels x bands matrix vs. GFP Welch + head RMS ==\n";
+  out() << "(cost per second of 8-channel data on top of the per-channel Welch)\n";
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("fs", 6)
+               .arg("legacy us", 12)
+               .arg("matrix us", 12)
+               .arg("speedup", 9);
+
+  const int channels = 8;
+  for (double fs : {250.0, 500.0, 1000.0, 2000.0}) {
+    const int n = int(fs);
+    QVector<double> block = randomSignal(n * channels); // 1 s interleaved
+
+    // Bisher: Kanalmittel in eigenen Welch-Schätzer, RMS über 2 s Puffer
+    // (Head-Plot 2x/s), Bandintegral 4x/s
+    WelchEstimator gfp(fs, WelchEstimator::Config{1024, 0.75, 8});
+    QVector<QVector<double>> head(channels);
+    QVector<double> frame(n);
+    const double tLegacy = timeIt([&] {
+      for (int f = 0; f < n; ++f) {
+        double sum = 0.0;
+        for (int ch = 0; ch < channels; ++ch)
+          sum += block[f * channels + ch];
+        frame[f] = sum / channels;
+      }
+      gfp.append(frame.constData(), n);
+
+      for (int ch = 0; ch < channels; ++ch) {
+        for (int f = 0; f < n; ++f)
+          head[ch].append(block[f * channels + ch]);
+        if (head[ch].size() > 3 * n)
+          head[ch].remove(0, head[ch].size() - 2 * n);
+      }
+      volatile double rms = 0.0;
+      for (int rep = 0; rep < 2; ++rep)
+        for (const auto &buf : std::as_const(head)) {
+          double sq = 0.0;
+          for (double v : buf)
+            sq += v * v;
+          rms = rms + std::sqrt(sq / buf.size());
+        }
+      volatile double bp = 0.0;
+      for (int rep = 0; rep < 4; ++rep)
+        for (double v : gfp.psd())
+          bp = bp + v;
+    });
+
+    // Neu: Matrix 4x/s aus den ohnehin vorhandenen Kanal-PSDs
+    WelchEstimator est(fs, WelchEstimator::Config{1024, 0.75, 8}, channels);
+    while (!est.isReady())
+      est.append(block.constData(), n, channels);
+    BandPowerMatrix matrix(channels);
+    const double tMatrix = timeIt([&] {
+      for (int rep = 0; rep < 4; ++rep)
+        matrix.update(est);
+    });
+
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(fs, 6, 'f', 0)
+                 .arg(tLegacy, 12, 'f', 2)
+                 .arg(tMatrix, 12, 'f', 2)
+                 .arg(tLegacy / tMatrix, 8, 'f', 2);
+  }
+}
+
+void fftBatch() {
+  const int N = 1024;
+  out() << QString("\n== FFT: %1-point power spectra, batched (SoA) vs. "
+                   "per-channel loop ==\n")
+               .arg(N);
+  out() << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg("ch", 4)
+               .arg("legacy us", 12)
+               .arg("loop us", 12)
+               .arg("batch us", 12)
+               .arg("vs legacy", 10)
+               .arg("vs loop", 9);
+
+  auto plan = FftPlan::forSize(N);
+  const QVector<double> &win = *FftPlan::hannWindow(N);
+  const int K = N / 2 + 1;
+
+  for (int C : {8, 32, 64}) {
+    const QVector<double> x = randomSignal(N * C); // interleaviert [n * C + c]
+
+    // Bisher: computeMagnitudeSpectrum je Kanal (allokiert pro Aufruf)
+    const double tLegacy = timeIt([&] {
+      QVector<double> sig(N);
+      for (int c = 0; c < C; ++c) {
+        for (int n = 0; n < N; ++n)
+          sig[n] = x[n * C + c];
+        volatile double sink = legacyMagnitude(sig, N)[1];
+        (void)sink;
+      }
+    });
+
+    // FftPlan, aber weiterhin ein Aufruf pro Kanal
+    FftWorkspace ws;
+    ws.ensure(N);
+    QVector<double> powerLoop(C * K);
+    const double tLoop = timeIt([&] {
+      for (int c = 0; c < C; ++c) {
+        for (int n = 0; n < N; ++n)
+          ws.input[n] = x[n * C + c] * win[n];
+        plan->forwardReal(ws.input.data(), ws.bins.data());
+        for (int k = 0; k < K; ++k)
+          powerLoop[c * K + k] = std::norm(ws.bins[k]);
+      }
+    });
+
+    // Ein Aufruf für alle Kanäle in die vorallozierte Kanäle x Bins-Matrix
+    QVector<double> windowed(N * C);
+    FftBatchWorkspace bws;
+    QVector<double> powerBatch(C * K);
+    const double tBatch = timeIt([&] {
+      for (int n = 0; n < N; ++n)
+        for (int c = 0; c < C; ++c)
+          windowed[n * C + c] = x[n * C + c] * win[n];
+      plan->forwardPowerBatch(windowed.constData(), C, bws, powerBatch.data());
+    });
+
+    out() << QString("%1 %2 %3 %4 %5 %6\n")
+                 .arg(C, 4)
+                 .arg(tLegacy, 12, 'f', 1)
+                 .arg(tLoop, 12, 'f', 1)
+                 .arg(tBatch, 12, 'f', 1)
+                 .arg(tLegacy / tBatch, 9, 'f', 2)
+                 .arg(tLoop / tBatch, 8, 'f', 2);
+  }
+}
+
+void sampleHistory() {
+  out() << "\n== History: shared ring (O(1)/sample) vs. QVector append + "
+           "remove(0, n) ==\n";
+  out() << "(1 s of 8-channel data, frame by frame, 3 s window)\n";
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("fs", 6)
+               .arg("legacy us", 12)
+               .arg("ring us", 12)
+               .arg("speedup", 9);
+
+  const int channels = 8;
+  for (double fs : {250.0, 1000.0, 4000.0, 16000.0}) {
+    const int n = int(fs);
+    const int window = 3 * n;
+    const QVector<double> block = randomSignal(n * channels);
+
+    // Bisher: eine QVector-Historie pro Kanal, kürzen ab 1.5 x Fenster
+    QVector<QVector<double>> buffers(channels);
+    const double tLegacy = timeIt([&] {
+      for (int f = 0; f < n; ++f)
+        for (int ch = 0; ch < channels; ++ch) {
+          QVector<double> &buf = buffers[ch];
+          buf.append(block[f * channels + ch]);
+          if (buf.size() > window * 3 / 2)
+            buf.remove(0, buf.size() - window);
+        }
+    });
+
+    SampleHistory history(channels, window);
+    const double tRing = timeIt([&] {
+      for (int f = 0; f < n; ++f)
+        history.append(block.constData() + f * channels, 1, channels);
+    });
+
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(fs, 6, 'f', 0)
+                 .arg(tLegacy, 12, 'f', 1)
+                 .arg(tRing, 12, 'f', 1)
+                 .arg(tLegacy / tRing, 8, 'f', 2);
+  }
+}
+
+void runningRms() {
+  out() << "\n== Head-map RMS: running accumulator (30 Hz) vs. 2 s rescan "
+           "(2 Hz) ==\n";
+  out() << "(cost per second of data at 2 kSPS)\n";
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg("ch", 4)
+               .arg("rescan us", 12)
+               .arg("window us", 12)
+               .arg("exp us", 12)
+               .arg("rescan/window", 14);
+
+  const double fs = 2000.0;
+  const int n = int(fs);
+  for (int C : {8, 32, 64}) {
+    const QVector<double> block = randomSignal(n * C); // 1 s interleaviert
+
+    // Bisher: 2 s Puffer je Kanal, zweimal pro Sekunde komplett summiert
+    QVector<double> buffer = randomSignal(2 * n * C);
+    const double tRescan = timeIt([&] {
+      volatile double sink = 0.0;
+      for (int rep = 0; rep < 2; ++rep)
+        for (int ch = 0; ch < C; ++ch) {
+          double sq = 0.0;
+          for (int i = 0; i < 2 * n; ++i)
+            sq += buffer[i * C + ch] * buffer[i * C + ch];
+          sink = sink + std::sqrt(sq / (2 * n));
+        }
+    });
+
+    double t[2];
+    const RunningRms::Mode modes[2] = {RunningRms::Mode::Window,
+                                       RunningRms::Mode::Exponential};
+    for (int m = 0; m < 2; ++m) {
+      RunningRms rms(C, fs, 2.0, modes[m]);
+      t[m] = timeIt([&] {
+        // In 30 Stücken anhängen, nach jedem die Aktivitäten abfragen
+        volatile double sink = 0.0;
+        for (int k = 0; k < 30; ++k) {
+          const int f0 = k * n / 30, f1 = (k + 1) * n / 30;
+          rms.processBlock(block.constData() + f0 * C, f1 - f0, C);
+          sink = sink + rms.rmsAll()[0];
+        }
+      });
+    }
+
+    out() << QString("%1 %2 %3 %4 %5\n")
+                 .arg(C, 4)
+                 .arg(tRescan, 12, 'f', 1)
+                 .arg(t[0], 12, 'f', 1)
+                 .arg(t[1], 12, 'f', 1)
+                 .arg(tRescan / t[0], 13, 'f', 2);
+  }
+}
+
+void spectralCache() {
+  out() << "\n== Spectral cache: N views of the same 8-channel Welch spec ==\n";
+  out() << "(1 s of data at 500 SPS, 2 s Hann window, 75 % overlap)\n";
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg("views", 6)
+               .arg("no cache us", 12)
+               .arg("cache us", 12)
+               .arg("hit rate", 9)
+               .arg("segs/s", 8);
+
+  const int channels = 8;
+  const double fs = 500.0;
+  const int n = int(fs);
+  const QVector<double> block = randomSignal(n * channels);
+  WelchEstimator::Config cfg;
+  cfg.segmentSeconds = 2.0;
+  cfg.overlap = 0.75;
+
+  for (int views : {1, 2, 4, 8}) {
+    double t[2];
+    SpectralCache cache(1024);
+    for (int cached = 0; cached < 2; ++cached) {
+      QVector<WelchEstimator *> est;
+      for (int v = 0; v < views; ++v) {
+        est.append(new WelchEstimator(fs, cfg, channels));
+        if (cached)
+          est[v]->setCache(&cache);
+      }
+      cache.resetStats();
+      t[cached] = timeIt([&] {
+        for (WelchEstimator *e : std::as_const(est))
+          e->append(block.constData(), n, channels);
+      });
+      qDeleteAll(est);
+    }
+
+    // Tatsächlich transformierte Segmente (Batch über alle Kanäle) pro s
+    const SpectralCache::Stats st = cache.stats();
+    const int hop = WelchEstimator(fs, cfg).hopLength();
+    const double perSecond = (1.0 - st.hitRate()) * views * fs / hop;
+    out() << QString("%1 %2 %3 %4 %5\n")
+                 .arg(views, 6)
+                 .arg(t[0], 12, 'f', 1)
+                 .arg(t[1], 12, 'f', 1)
+                 .arg(100.0 * st.hitRate(), 8, 'f', 1)
+                 .arg(perSecond, 8, 'f', 1);
+  }
+}
+
+void chirpZ() {
+  const double maxHz = 30.0, stepHz = 0.05;
+  out() << QString("\n== Zoom spectrum 0-%1 Hz in %2 Hz steps (3 s segment): "
+                   "chirp-z vs. padded FFT ==\n")
+               .arg(maxHz)
+               .arg(stepHz);
+  out() << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+               .arg("fs", 6)
+               .arg("N", 6)
+               .arg("pad N", 7)
+               .arg("padded us", 12)
+               .arg("CZT P", 7)
+               .arg("chirp-z us", 12)
+               .arg("pair us/ch", 12)
+               .arg("speedup", 9)
+               .arg("max rel", 10);
+
+  const int points = int(maxHz / stepHz) + 1;
+  for (double fs : {250.0, 500.0, 1000.0, 2000.0}) {
+    const int N = int(3.0 * fs);
+    const QVector<double> x = randomSignal(N);
+
+    // Bisher: Nullen bis zur Rasterweite fs/N' = stepHz anhängen
+    const int padN = FftPlan::goodSize(int(std::ceil(fs / stepHz)));
+    auto plan = FftPlan::forSize(padN);
+    FftWorkspace ws;
+    ws.ensure(padN);
+    QVector<double> padPower(points);
+    const double tPad = timeIt([&] {
+      std::copy(x.constBegin(), x.constEnd(), ws.input.data());
+      std::fill(ws.input.data() + N, ws.input.data() + padN, 0.0);
+      plan->forwardReal(ws.input.data(), ws.bins.data());
+      // Bin k liegt bei k * fs/padN, davon nur 0..maxHz
+      for (int m = 0; m < points; ++m)
+        padPower[m] = std::norm(ws.bins[qRound(m * stepHz * padN / fs)]);
+    });
+
+    auto cz = ChirpZ::forSpec(N, fs, 0.0, stepHz, points);
+    ChirpZWorkspace czWs;
+    QVector<double> czPower(points);
+    const double tCz =
+        timeIt([&] { cz->power(x.constData(), 1, czWs, czPower.data()); });
+
+    // Zwei Kanäle pro Transformation (wie im WelchEstimator)
+    const QVector<double> y = randomSignal(N);
+    auto sym = ChirpZ::symmetric(N, fs, stepHz, points);
+    QVector<double> pairX(points), pairY(points);
+    const double tPair = 0.5 * timeIt([&] {
+      sym->powerPair(x.constData(), y.constData(), 1, czWs, pairX.data(),
+                     pairY.data());
+    });
+
+    double maxRel = 0.0;
+    for (int m = 0; m < points; ++m)
+      maxRel = std::max(maxRel, std::abs(pairX[m] - czPower[m]) /
+                                    std::max(1e-12, czPower[m]));
+
+    out() << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+                 .arg(fs, 6, 'f', 0)
+                 .arg(N, 6)
+                 .arg(padN, 7)
+                 .arg(tPad, 12, 'f', 1)
+                 .arg(cz->fftLength(), 7)
+                 .arg(tCz, 12, 'f', 1)
+                 .arg(tPair, 12, 'f', 1)
+                 .arg(tPad / tPair, 8, 'f', 2)
+                 .arg(maxRel, 10, 'g', 2);
+  }
+}
+
+void connectivity() {
+  const double fs = 250.0;
+  const int threads = QThread::idealThreadCount();
+  out() << QString("\n== Connectivity (coherence + PLV, 5 bands, 2 s segments "
+                   "@ %1 SPS): per segment, 1 vs. %2 threads ==\n")
+               .arg(fs)
+               .arg(threads);
+  out() << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg("ch", 4)
+               .arg("pairs", 6)
+               .arg("welch us", 10)
+               .arg("1 thr us", 10)
+               .arg("N thr us", 10)
+               .arg("speedup", 9);
+
+  WelchEstimator::Config config;
+  config.segmentSeconds = 2.0;
+  config.overlap = 0.5;
+  for (int C : {8, 16, 32, 64}) {
+    WelchEstimator estimator(fs, config, C);
+    estimator.setKeepSpectra(true);
+    const int hop = estimator.hopLength();
+    const QVector<double> x = randomSignal(hop * C);
+
+    // Segment-FFTs, die ohnehin für die PSD anfallen
+    estimator.append(x.constData(), hop, C);
+    const double tWelch = timeIt([&] {
+      estimator.append(x.constData(), hop, C);
+      estimator.append(x.constData(), hop, C);
+    }) / 2.0;
+
+    double t[2] = {0.0, 0.0};
+    for (int i = 0; i < 2; ++i) {
+      ConnectivityEstimator conn(C);
+      conn.setMaxThreads(i == 0 ? 1 : threads);
+      t[i] = timeIt([&] {
+        conn.addSegment(estimator);
+        const ConnectivityEstimator::Matrix m = conn.compute();
+        Q_UNUSED(m);
+      });
+    }
+
+    out() << QString("%1 %2 %3 %4 %5 %6\n")
+                 .arg(C, 4)
+                 .arg(C * (C - 1) / 2, 6)
+                 .arg(tWelch, 10, 'f', 1)
+                 .arg(t[0], 10, 'f', 1)
+                 .arg(t[1], 10, 'f', 1)
+                 .arg(t[0] / t[1], 8, 'f', 2);
+  }
+}
+
+void traceViews() {
+  const double fs = 1000.0; // Anzeige-Rate nach der Dezimierung
+  const int frames = int(3.0 * fs);
+  const QSize size(900, 600);
+  out() << QString("\n== EEG traces, 3 s @ %1 SPS, %2x%3 px: one QCustomPlot "
+                   "per channel vs. stacked montage (ms per frame) ==\n")
+               .arg(fs)
+               .arg(size.width())
+               .arg(size.height());
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("ch", 4)
+               .arg("plots ms", 10)
+               .arg("montage ms", 12)
+               .arg("speedup", 9);
+
+  for (int C : {8, 32, 64}) {
+    const QVector<double> x = randomSignal(frames * C);
+    QVector<double> keys(frames);
+    for (int f = 0; f < frames; ++f)
+      keys[f] = f / fs;
+
+    // Bisher: je Kanal ein Plot, pro Frame Range + Rescale + Replot
+    QVector<QCustomPlot *> plots;
+    for (int c = 0; c < C; ++c) {
+      auto *plot = new QCustomPlot;
+      plot->resize(size.width(), size.height() / C);
+      plot->addGraph();
+      QVector<double> values(frames);
+      for (int f = 0; f < frames; ++f)
+        values[f] = x[f * C + c];
+      plot->graph(0)->setData(keys, values, true);
+      plots.append(plot);
+    }
+    const double tPlots = timeIt([&] {
+      for (QCustomPlot *plot : std::as_const(plots)) {
+        plot->xAxis->setRange(0.0, keys.last());
+        plot->graph(0)->rescaleValueAxis(false, true);
+        plot->replot(QCustomPlot::rpImmediateRefresh);
+      }
+    });
+    qDeleteAll(plots);
+
+    EegMontageView montage;
+    QStringList labels;
+    for (int c = 0; c < C; ++c)
+      labels << QString("Ch%1").arg(c + 1);
+    montage.setChannels(labels, QVector<QColor>(C, QColor(Qt::blue)));
+    montage.resize(size);
+    montage.appendFrames(x.constData(), frames, C, 0.0, 1.0 / fs);
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    const double tMontage = timeIt([&] {
+      montage.setAllScales(0.0); // alle Spalten neu, wie ein Plot-Replot
+      montage.render(&image);
+    });
+
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(C, 4)
+                 .arg(tPlots / 1000.0, 10, 'f', 2)
+                 .arg(tMontage / 1000.0, 12, 'f', 2)
+                 .arg(tPlots / tMontage, 8, 'f', 2);
+  }
+}
+
+void streamingGraph() {
+  const double windowSec = 3.0;
+  out() << QString("\n== Streaming trace, 3 s window, 30 Hz ticks (append + "
+                   "trim + value range): QCPGraph vs. StreamingGraph ==\n");
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("SPS", 6)
+               .arg("QCPGraph us/s", 14)
+               .arg("ring us/s", 12)
+               .arg("speedup", 9);
+
+  for (double fs : {250.0, 1000.0, 2000.0}) {
+    const int perTick = int(fs / 30.0);
+    const int ticks = 300; // 10 s Daten
+    const QVector<double> x = randomSignal(perTick * ticks);
+    const double dt = 1.0 / fs;
+
+    QCustomPlot plot;
+    QCPGraph *graph = plot.addGraph();
+    auto *ring = new StreamingGraph(plot.xAxis, plot.yAxis);
+    ring->configure(dt, int(std::ceil(windowSec / dt)) + 1);
+
+    double t[2] = {0.0, 0.0};
+    for (int variant = 0; variant < 2; ++variant) {
+      qint64 n = 0;
+      t[variant] = timeIt([&] {
+        for (int k = 0; k < ticks; ++k, ++n) {
+          const double t0 = (n * perTick) * dt;
+          const double tEnd = t0 + (perTick - 1) * dt;
+          const double *v = x.constData() + k * perTick;
+          if (variant == 0) {
+            for (int i = 0; i < perTick; ++i)
+              graph->addData(t0 + i * dt, v[i]);
+            graph->data()->removeBefore(tEnd - windowSec);
+            plot.xAxis->setRange(tEnd - windowSec, tEnd);
+            graph->rescaleValueAxis(false, true);
+          } else {
+            ring->addSamples(v, perTick, 1, t0);
+            plot.xAxis->setRange(tEnd - windowSec, tEnd);
+            ring->rescaleValueAxis(false, true);
+          }
+        }
+      });
+    }
+
+    // pro Sekunde Daten
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(fs, 6, 'f', 0)
+                 .arg(t[0] / 10.0, 14, 'f', 1)
+                 .arg(t[1] / 10.0, 12, 'f', 1)
+                 .arg(t[0] / t[1], 8, 'f', 2);
+  }
+}
+
+void minMaxEnvelope() {
+  const int C = 32;
+  const int width = 900;
+  const double windowSec = 3.0;
+  out() << QString("\n== Trace envelope, %1 ch, 3 s in %2 columns, 30 Hz "
+                   "frames: full scan per paint vs. incremental cache "
+                   "(us per frame) ==\n")
+               .arg(C)
+               .arg(width);
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("SPS", 6)
+               .arg("scan us", 10)
+               .arg("cache us", 10)
+               .arg("speedup", 9);
+
+  for (double fs : {250.0, 1000.0, 4000.0, 16000.0}) {
+    const int n = int(windowSec * fs);
+    const int perTick = int(fs / 30.0);
+    const int ticks = 90;
+    const QVector<double> x = randomSignal((n + perTick * ticks) * C);
+    const double samplesPerColumn = double(n) / width;
+    QVector<double> lo(width + 1), hi(width + 1);
+
+    // Bisher: je Frame alle Samples im Fenster auf Spalten verteilen
+    int tick = 0;
+    const double tScan = timeIt([&] {
+      const double *frame = x.constData() + (tick++ % ticks) * perTick * C;
+      for (int c = 0; c < C; ++c) {
+        int col = -1;
+        for (int i = 0; i < n; ++i) {
+          const double v = frame[i * C + c];
+          const int j = int(i / samplesPerColumn);
+          if (j != col) {
+            col = j;
+            lo[j] = hi[j] = v;
+          } else {
+            lo[j] = std::min(lo[j], v);
+            hi[j] = std::max(hi[j], v);
+          }
+        }
+      }
+      volatile double sink = lo[0] + hi[width - 1];
+      (void)sink;
+    });
+
+    // Cache: nur neue Samples einsortieren, je Frame Breite Spalten lesen
+    MinMaxEnvelope envelope(C);
+    envelope.configure(samplesPerColumn, width);
+    envelope.append(x.constData(), n, C, 0);
+    qint64 next = n;
+    const double tCache = timeIt([&] {
+      const int offset = n + (tick++ % ticks) * perTick;
+      envelope.append(x.constData() + offset * C, perTick, C, next);
+      next += perTick;
+      const qint64 end = envelope.lastColumn() + 1;
+      const qint64 begin = std::max(envelope.firstColumn(), end - width);
+      double sum = 0.0;
+      for (int c = 0; c < C; ++c)
+        for (qint64 j = begin; j < end; ++j)
+          sum += envelope.high(j, c) - envelope.low(j, c);
+      volatile double sink = sum;
+      (void)sink;
+    });
+
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(fs, 6, 'f', 0)
+                 .arg(tScan, 10, 'f', 1)
+                 .arg(tCache, 10, 'f', 1)
+                 .arg(tScan / tCache, 8, 'f', 2);
+  }
+}
+
+void montageRendering() {
+  const int C = 32;
+  const QSize size(900, 600);
+  out() << QString("\n== Montage, %1 ch, %2x%3 px, 30 Hz frames with new "
+                   "data: full repaint vs. incremental (ms per frame) ==\n")
+               .arg(C)
+               .arg(size.width())
+               .arg(size.height());
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg("SPS", 6)
+               .arg("full ms", 10)
+               .arg("scroll ms", 10)
+               .arg("sweep ms", 10)
+               .arg("speedup", 9);
+
+  QStringList labels;
+  for (int c = 0; c < C; ++c)
+    labels << QString("Ch%1").arg(c + 1);
+  QImage image(size, QImage::Format_ARGB32_Premultiplied);
+
+  for (double fs : {250.0, 1000.0, 4000.0}) {
+    const int perTick = int(fs / 30.0);
+    const int blocks = 300;
+    const QVector<double> x = randomSignal(perTick * blocks * C);
+    const double dt = 1.0 / fs;
+
+    double t[3] = {0.0, 0.0, 0.0};
+    for (int variant = 0; variant < 3; ++variant) {
+      EegMontageView montage;
+      montage.setChannels(labels, QVector<QColor>(C, QColor(Qt::blue)));
+      montage.setRenderMode(variant == 2 ? EegMontageView::SweepMode
+                                         : EegMontageView::ScrollMode);
+      montage.resize(size);
+      qint64 frame = 0;
+      auto tick = [&] {
+        const double *block = x.constData() + (frame % blocks) * perTick * C;
+        montage.appendFrames(block, perTick, C, frame * perTick * dt, dt);
+        ++frame;
+      };
+      // Fenster füllen, dann pro Aufruf ein Frame
+      for (int k = 0; k < 100; ++k)
+        tick();
+      montage.render(&image);
+      t[variant] = timeIt([&] {
+        tick();
+        if (variant == 0)
+          montage.setAllScales(0.0); // alle Spalten neu zeichnen
+        montage.render(&image);
+      });
+    }
+
+    out() << QString("%1 %2 %3 %4 %5\n")
+                 .arg(fs, 6, 'f', 0)
+                 .arg(t[0] / 1000.0, 10, 'f', 3)
+                 .arg(t[1] / 1000.0, 10, 'f', 3)
+                 .arg(t[2] / 1000.0, 10, 'f', 3)
+                 .arg(t[0] / t[1], 8, 'f', 2);
+  }
+}
+
+void topoHeatmap() {
+  // Layout wie ElectrodeMap (8 Kanäle + Referenz)
+  const double headR = 80;
+  const QVector<QPointF> positions = {
+      {-headR * 0.25, -headR * 0.9}, {headR * 0.25, -headR * 0.9},
+      {-headR * 0.5, -headR * 0.7},  {headR * 0.5, -headR * 0.7},
+      {0, -headR * 0.3},             {0, headR * 0.25},
+      {-headR * 0.7, headR * 0.5},   {headR * 0.7, headR * 0.5},
+      {0, 0}};
+  out() << "\n== Topomap heatmap 300x300: per-pixel IDW + setPixelColor vs. "
+           "precomputed weights + LUT (us per update) ==\n";
+  out() << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg("elec", 5)
+               .arg("legacy us", 12)
+               .arg("cached us", 12)
+               .arg("+pixmap us", 12)
+               .arg("speedup", 9)
+               .arg("max diff", 9);
+
+  for (int electrodes : {8, 9}) {
+    QVector<QVector<double>> frames(30);
+    for (auto &a : frames) {
+      a.resize(electrodes);
+      for (double &v : a)
+        v = QRandomGenerator::global()->generateDouble();
+    }
+    int k = 0;
+    const double tLegacy = timeIt([&] {
+      QImage img = legacyHeatmap(positions, frames[k++ % frames.size()]);
+      volatile int sink = img.width();
+      (void)sink;
+    });
+
+    TopoHeatmap heatmap;
+    heatmap.setMethod(TopoHeatmap::InverseDistance);
+    heatmap.setLayout(positions, headR);
+    heatmap.setSize(300, 300);
+    heatmap.render(frames[0]); // Gewichte aufbauen
+    const double tCached = timeIt([&] {
+      const QImage &img = heatmap.render(frames[k++ % frames.size()]);
+      volatile QRgb sink = img.pixel(150, 150);
+      (void)sink;
+    });
+    const double tPixmap = timeIt([&] {
+      QPixmap pm = QPixmap::fromImage(heatmap.render(frames[k++ % frames.size()]));
+      volatile int sink = pm.width();
+      (void)sink;
+    });
+
+    // Abweichung je Farbkanal gegenüber der bisherigen Ausgabe
+    int maxDiff = 0;
+    for (const auto &a : frames) {
+      const QImage ref = legacyHeatmap(positions, a);
+      const QImage &img = heatmap.render(a);
+      for (int y = 0; y < 300; ++y)
+        for (int x = 0; x < 300; ++x) {
+          const QRgb p = ref.pixel(x, y), q = img.pixel(x, y);
+          maxDiff = std::max({maxDiff, std::abs(qRed(p) - qRed(q)),
+                              std::abs(qGreen(p) - qGreen(q)),
+                              std::abs(qAlpha(p) - qAlpha(q))});
+        }
+    }
+
+    out() << QString("%1 %2 %3 %4 %5 %6\n")
+                 .arg(electrodes, 5)
+                 .arg(tLegacy, 12, 'f', 1)
+                 .arg(tCached, 12, 'f', 1)
+                 .arg(tPixmap, 12, 'f', 1)
+                 .arg(tLegacy / tCached, 8, 'f', 1)
+                 .arg(maxDiff, 9);
+    // Farbtabelle: höchstens 1 LSB je Kanal
+    check(maxDiff <= 1,
+          QString("IDW heatmap vs. legacy, %1 electrodes").arg(electrodes));
+  }
+
+  // Kern der Splines: Legendre-Rekursion gegen bekannte Werte
+  const double p2 = TopoHeatmap::legendre(2, 0.0);
+  const double p3 = TopoHeatmap::legendre(3, 0.5);
+  const bool legendreOk =
+      std::abs(p2 + 0.5) < 1e-12 && std::abs(p3 + 0.4375) < 1e-12;
+  out() << QString("\nLegendre check: P2(0) = %1 (-0.5), P3(0.5) = %2 "
+                   "(-0.4375): %3\n")
+               .arg(p2)
+               .arg(p3)
+               .arg(legendreOk ? "ok" : "FAILED");
+  check(legendreOk, "Legendre recurrence");
+
+  // Sphärische Splines: Aufbau je Layout, danach gleiches Produkt pro Frame
+  out() << "\n== Topomap heatmap 300x300, spherical splines: weight build "
+           "per montage vs. per-frame update ==\n";
+  out() << QString("%1 %2 %3\n")
+               .arg("elec", 5)
+               .arg("build ms", 12)
+               .arg("frame us", 12);
+  for (int electrodes : {8, 32, 64}) {
+    // Gleichmäßig verteilte Kappe bis 100° Polarwinkel
+    QVector<QPointF> cap;
+    QVector<QVector<double>> frames(30);
+    for (int e = 0; e < electrodes; ++e)
+      cap.append(TopoHeatmap::projectTenTwenty(
+          100.0 * std::sqrt((e + 0.5) / electrodes), e * 137.508, headR));
+    for (auto &a : frames) {
+      a.resize(electrodes);
+      for (double &v : a)
+        v = QRandomGenerator::global()->generateDouble();
+    }
+    TopoHeatmap heatmap;
+    heatmap.setLayout(cap, headR);
+    heatmap.setSize(300, 300);
+    QElapsedTimer build;
+    build.start();
+    heatmap.render(frames[0]);
+    const double tBuild = build.nsecsElapsed() / 1e6;
+    int k = 0;
+    const double tFrame = timeIt([&] {
+      const QImage &img = heatmap.render(frames[k++ % frames.size()]);
+      volatile QRgb sink = img.pixel(150, 150);
+      (void)sink;
+    });
+    out() << QString("%1 %2 %3\n")
+                 .arg(electrodes, 5)
+                 .arg(tBuild, 12, 'f', 1)
+                 .arg(tFrame, 12, 'f', 1);
+  }
+
+  // Auflösungsstufen (Zoom): Kosten folgen den Pixeln auf dem Schirm
+  out() << "\n== Topomap heatmap, 8 ch spherical splines, per resolution "
+           "level (pixels per scene unit) ==\n";
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("px/unit", 8)
+               .arg("pixels", 9)
+               .arg("build ms", 12)
+               .arg("frame us", 12);
+  QVector<QVector<double>> frames(30);
+  for (auto &a : frames) {
+    a.resize(8);
+    for (double &v : a)
+      v = QRandomGenerator::global()->generateDouble();
+  }
+  TopoHeatmap heatmap;
+  heatmap.setLayout(positions.mid(0, 8), headR);
+  heatmap.setSize(300, 300);
+  heatmap.render(frames[0]); // Grundstufe
+  for (double resolution : {0.5, 1.0, 2.0, 4.0}) {
+    heatmap.setResolution(resolution);
+    QElapsedTimer build;
+    build.start();
+    // In der Anwendung als Pool-Job (ElectrodeMap), hier direkt
+    if (heatmap.levelPending())
+      heatmap.addLevel(TopoHeatmap::buildLevel(heatmap.pendingLevel()));
+    heatmap.render(frames[0]);
+    const double tBuild = build.nsecsElapsed() / 1e6;
+    int k = 0;
+    const double tFrame = timeIt([&] {
+      const QImage &img = heatmap.render(frames[k++ % frames.size()]);
+      volatile int sink = img.width();
+      (void)sink;
+    });
+    out() << QString("%1 %2 %3 %4\n")
+                 .arg(heatmap.resolution(), 8, 'f', 2)
+                 .arg(heatmap.pixelCount(), 9)
+                 .arg(tBuild, 12, 'f', 1)
+                 .arg(tFrame, 12, 'f', 1);
+  }
+}
+
+void electrodeMapUpdate() {
+  const double headR = 80;
+  const QVector<QPointF> positions = {
+      {-headR * 0.25, -headR * 0.9}, {headR * 0.25, -headR * 0.9},
+      {-headR * 0.5, -headR * 0.7},  {headR * 0.5, -headR * 0.7},
+      {0, -headR * 0.3},             {0, headR * 0.25},
+      {-headR * 0.7, headR * 0.5},   {headR * 0.7, headR * 0.5},
+      {0, 0}};
+  const QStringList labels{"Fp1", "Fp2", "F7", "F8", "Fz",
+                           "Pz",  "T5",  "T6", "Ref"};
+  out() << "\n== ElectrodeMap update (8 ch), scene + paint into 300x300: "
+           "clear and rebuild vs. persistent items (us per update) ==\n";
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("variant", 12)
+               .arg("update us", 12)
+               .arg("+paint us", 12)
+               .arg("items", 7);
+
+  QVector<QVector<double>> frames(30);
+  for (auto &a : frames) {
+    a.resize(8);
+    for (double &v : a)
+      v = QRandomGenerator::global()->generateDouble();
+  }
+  QImage target(300, 300, QImage::Format_ARGB32_Premultiplied);
+  const QRectF area(-150, -150, 300, 300);
+  int k = 0;
+
+  // Bisher: Heatmap wie jetzt, aber die Szene bei jedem Update neu
+  QGraphicsScene legacy;
+  TopoHeatmap heatmap;
+  heatmap.setLayout(positions, headR);
+  heatmap.setSize(300, 300);
+  auto legacyUpdate = [&] {
+    legacyRebuildScene(legacy, positions, labels,
+                       heatmap.render(frames[k++ % frames.size()]));
+  };
+  const double tLegacy = timeIt(legacyUpdate);
+  const double tLegacyPaint = timeIt([&] {
+    legacyUpdate();
+    QPainter painter(&target);
+    legacy.render(&painter, QRectF(target.rect()), area);
+  });
+
+  ElectrodeMap map;
+  auto update = [&] { map.setActivities(frames[k++ % frames.size()]); };
+  const double tMap = timeIt(update);
+  const double tMapPaint = timeIt([&] {
+    update();
+    QPainter painter(&target);
+    map.render(&painter, QRectF(target.rect()), area);
+  });
+
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("rebuild", 12)
+               .arg(tLegacy, 12, 'f', 1)
+               .arg(tLegacyPaint, 12, 'f', 1)
+               .arg(legacy.items().size(), 7);
+  out() << QString("%1 %2 %3 %4\n")
+               .arg("persistent", 12)
+               .arg(tMap, 12, 'f', 1)
+               .arg(tMapPaint, 12, 'f', 1)
+               .arg(map.items().size(), 7);
+}
+
+void autoscale() {
+  const int C = 32;
+  out() << QString("\n== Autoscale, %1 ch, 30 Hz frames: min/max scan over "
+                   "the window vs. SlidingRange (us per frame) ==\n")
+               .arg(C);
+  out() << QString("%1 %2 %3 %4 %5\n")
+               .arg("window s", 9)
+               .arg("SPS", 6)
+               .arg("scan us", 10)
+               .arg("sliding us", 11)
+               .arg("speedup", 9);
+
+  for (double windowSec : {3.0, 10.0}) {
+    for (double fs : {250.0, 1000.0, 4000.0, 16000.0}) {
+      const int n = int(windowSec * fs);
+      const int perTick = int(fs / 30.0);
+      const int ticks = 90;
+      const QVector<double> x = randomSignal((n + perTick * ticks) * C);
+
+      // Bisher: je Frame und Kanal das ganze Fenster absuchen
+      int tick = 0;
+      const double tScan = timeIt([&] {
+        const double *frame = x.constData() + (tick++ % ticks) * perTick * C;
+        double sum = 0.0;
+        for (int c = 0; c < C; ++c) {
+          double lo = frame[c], hi = frame[c];
+          for (int i = 1; i < n; ++i) {
+            lo = std::min(lo, frame[i * C + c]);
+            hi = std::max(hi, frame[i * C + c]);
+          }
+          sum += hi - lo;
+        }
+        volatile double sink = sum;
+        (void)sink;
+      });
+
+      // Mitlaufend: neue Samples einfügen, Überlaufprüfung der neuen
+      // Samples und robuster Bereich über das Fenster
+      QVector<SlidingRange> ranges(C);
+      for (int c = 0; c < C; ++c) {
+        ranges[c].configure(n);
+        ranges[c].append(x.constData() + c, n, C);
+      }
+      tick = 0;
+      const double tSliding = timeIt([&] {
+        const int offset = n + (tick++ % ticks) * perTick;
+        double sum = 0.0;
+        for (int c = 0; c < C; ++c) {
+          ranges[c].append(x.constData() + offset * C + c, perTick, C);
+          double lo = 0.0, hi = 0.0;
+          ranges[c].rangeOfLast(perTick, lo, hi);
+          sum += hi - lo;
+          ranges[c].robustRange(lo, hi);
+          sum += hi - lo;
+        }
+        volatile double sink = sum;
+        (void)sink;
+      });
+
+      out() << QString("%1 %2 %3 %4 %5\n")
+                   .arg(windowSec, 9, 'f', 0)
+                   .arg(fs, 6, 'f', 0)
+                   .arg(tScan, 10, 'f', 1)
+                   .arg(tSliding, 11, 'f', 1)
+                   .arg(tScan / tSliding, 8, 'f', 2);
+    }
+  }
+}
+
+} // namespace Benchmarks
@@ -0,0 +1,67 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+/**
+ * Mikro-Benchmarks der Signalverarbeitung.
+ * Aufruf: NeuroEase_bench  (eigenes Konsolenprogramm, Ergebnisse auf stdout)
+ */
+namespace Benchmarks {
+
+/// Alle Benchmarks; 1, wenn eine Plausibilitätsprüfung fehlschlägt
+int runAll();
+
+// FftPlan (reelle FFT, gecachte Tabellen) vs. alte MainWindow::fft,
+// Mixed-Radix-Längen vs. Padding auf die nächste 2er-Potenz
+void fftPlan();
+
+// Bandpower-Matrix aus den Kanal-PSDs vs. eigener GFP-Welch + RMS-Puffer
+void bandPowerMatrix();
+
+// Alle Kanäle in einem FFT-Aufruf (SoA) vs. Schleife über Kanäle
+void fftBatch();
+
+// Gemeinsamer Ring-Verlauf vs. QVector-Historien mit append + remove(0, n)
+void sampleHistory();
+
+// Laufender RMS (O(1)/Sample, Abfrage mit 30 Hz) vs. Neuberechnung 2x/s
+void runningRms();
+
+// N Spektralansichten gleicher Fensterspec mit/ohne gemeinsamen Cache
+void spectralCache();
+
+// Zoom 0..30 Hz in 0.05-Hz-Schritten: Chirp-Z vs. auf fs/0.05 aufgefüllte FFT
+void chirpZ();
+
+// Kohärenz/PLV aller Kanalpaare aus den Welch-Segment-FFTs, 1 vs. alle Kerne
+void connectivity();
+
+// Gestapelte Montage (ein Widget) vs. ein QCustomPlot je Kanal, pro Frame
+void traceViews();
+
+// Streaming-Spur: Ringpuffer mit impliziten Keys vs. QCPGraph
+// (addData + removeBefore), ohne Zeichnen
+void streamingGraph();
+
+// Min/Max-Hüllkurve je Pixelspalte: mitlaufender Cache vs. Scan je Frame
+void minMaxEnvelope();
+
+// Montage mit neuen Daten je Frame: volle Neuzeichnung vs. nur neue Spalten
+// (Scroll und Sweep)
+void montageRendering();
+
+// Topographie-Heatmap (300x300): IDW je Pixel mit setPixelColor vs.
+// vorberechnete Gewichte und Farbtabelle; sphärische Splines mit 8-64
+// Elektroden (Aufbau je Montage, Update je Frame) und je Auflösungsstufe
+void topoHeatmap();
+
+// ElectrodeMap-Update: Szene leeren und neu aufbauen vs. bestehende Items
+// (Heatmap-Bild tauschen)
+void electrodeMapUpdate();
+
+// Autoskala je Frame (32 Kanäle): Min/Max-Scan über das Fenster vs.
+// mitlaufende Deques und Block-Extrema (SlidingRange)
+void autoscale();
+
+} // namespace Benchmarks
+
+#endif // BENCHMARKS_H
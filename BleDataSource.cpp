@@ -180,14 +180,9 @@ void BleDataSource::serviceStateChanged(QLowEnergyService::ServiceState s) {
 void BleDataSource::serviceCharacteristicChanged(
     const QLowEnergyCharacteristic &c, const QByteArray &value) {
   if (c.uuid() == QBluetoothUuid(CHAR_TX_UUID)) {
-    // Check for text response (impedance result)
-    if (value.startsWith("IMP:")) {
-      QString text = QString::fromUtf8(value).trimmed();
-      QString valuesStr = text.mid(4); // Remove "IMP:"
-      QStringList values = valuesStr.split(',');
-      emit impedanceReceived(values);
+    // Textantwort (Impedanz, Lead-Off-Bestätigung)
+    if (handleResponse(value))
       return;
-    }
 
     m_incomingBuffer.append(value);
 
@@ -299,5 +294,5 @@ void BleDataSource::parsePacket(const QByteArray &data) {
     values.append(static_cast<double>(rawVal) * scaleToMicrovolts);
   }
 
-  emit newEEGData(values);
+  publishSample(values);
 }
@@ -0,0 +1,152 @@
+#include "ChirpZ.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace {
+
+// e^{i * sign * pi * step/fs * k^2}; Phase modulo 2pi vor der
+// Multiplikation, damit k^2 bei großen N keine Stellen kostet
+ChirpZ::Complex chirp(qint64 k, double stepOverFs, double sign) {
+  const double turns = std::fmod(0.5 * stepOverFs * double(k * k), 1.0);
+  const double ang = sign * 2.0 * M_PI * turns;
+  return ChirpZ::Complex(std::cos(ang), std::sin(ang));
+}
+
+} // namespace
+
+ChirpZ::ChirpZ(int n, double sampleRate, double startHz, double stepHz,
+               int points)
+    : m_n(std::max(1, n)), m_points(std::max(1, points)), m_startHz(startHz),
+      m_stepHz(stepHz) {
+  const int N = m_n;
+  const int M = m_points;
+
+  // Kleinste unterstützte komplexe Länge P >= N + M - 1
+  m_plan = FftPlan::forSize(FftPlan::goodSize(2 * (N + M - 1)));
+  m_fftLen = m_plan->size() / 2;
+  const int P = m_fftLen;
+
+  const double r = (sampleRate > 0.0) ? stepHz / sampleRate : 0.0;
+  const double f0 = (sampleRate > 0.0) ? startHz / sampleRate : 0.0;
+
+  m_pre.resize(N);
+  for (int i = 0; i < N; ++i) {
+    const double ang = -2.0 * M_PI * std::fmod(f0 * i, 1.0);
+    m_pre[i] = Complex(std::cos(ang), std::sin(ang)) * chirp(i, r, -1.0);
+  }
+
+  m_post.resize(M);
+  for (int m = 0; m < M; ++m)
+    m_post[m] = chirp(m, r, -1.0);
+
+  // Faltungskern v[k] = e^{+i a k^2} für k = -(N-1) .. M-1, zyklisch
+  QVector<Complex> v(P, Complex(0.0, 0.0));
+  for (int k = 0; k < M; ++k)
+    v[k] = chirp(k, r, 1.0);
+  for (int k = 1; k < N; ++k)
+    v[P - k] = chirp(k, r, 1.0);
+
+  m_kernel.resize(P);
+  m_plan->forwardComplex(v.constData(), m_kernel.data());
+  for (Complex &c : m_kernel)
+    c /= double(P); // Normierung der inversen FFT gleich mit
+}
+
+std::shared_ptr<const ChirpZ> ChirpZ::forSpec(int n, double sampleRate,
+                                              double startHz, double stepHz,
+                                              int points) {
+  using Key = std::tuple<int, double, double, double, int>;
+  static QMutex mutex;
+  static std::map<Key, std::shared_ptr<const ChirpZ>> cache;
+
+  const Key key(n, sampleRate, startHz, stepHz, points);
+  QMutexLocker lock(&mutex);
+  auto &entry = cache[key];
+  if (!entry)
+    entry = std::make_shared<const ChirpZ>(n, sampleRate, startHz, stepHz,
+                                           points);
+  return entry;
+}
+
+std::shared_ptr<const ChirpZ> ChirpZ::symmetric(int n, double sampleRate,
+                                                double stepHz, int halfPoints) {
+  return forSpec(n, sampleRate, -(halfPoints - 1) * stepHz, stepHz,
+                 2 * halfPoints - 1);
+}
+
+void ChirpZ::convolve(const double *re, const double *im, int stride,
+                      ChirpZWorkspace &ws) const {
+  const int N = m_n;
+  const int P = m_fftLen;
+  ws.ensure(P);
+  Complex *a = ws.a.data();
+  Complex *b = ws.b.data();
+
+  if (im) {
+    for (int i = 0; i < N; ++i)
+      a[i] = Complex(re[i * stride], im[i * stride]) * m_pre[i];
+  } else {
+    for (int i = 0; i < N; ++i)
+      a[i] = re[i * stride] * m_pre[i];
+  }
+  for (int i = N; i < P; ++i)
+    a[i] = Complex(0.0, 0.0);
+
+  m_plan->forwardComplex(a, b);
+
+  // Multiplikation mit dem Kernspektrum, inverse FFT über konjugierte
+  // Vorwärts-FFT: ifft(Z) = conj(fft(conj(Z))) / P (1/P steckt im Kern)
+  const Complex *kern = m_kernel.constData();
+  for (int k = 0; k < P; ++k)
+    b[k] = std::conj(b[k] * kern[k]);
+
+  m_plan->forwardComplex(b, a); // a = conj(Faltung)
+}
+
+void ChirpZ::transform(const double *in, int stride, ChirpZWorkspace &ws,
+                       Complex *out) const {
+  convolve(in, nullptr, stride, ws);
+  const Complex *a = ws.a.data();
+  for (int m = 0; m < m_points; ++m)
+    out[m] = m_post[m] * std::conj(a[m]);
+}
+
+void ChirpZ::power(const double *in, int stride, ChirpZWorkspace &ws,
+                   double *out) const {
+  // |post| = 1: die Leistung braucht den Nachchirp nicht
+  convolve(in, nullptr, stride, ws);
+  const Complex *a = ws.a.data();
+  for (int m = 0; m < m_points; ++m)
+    out[m] = std::norm(a[m]);
+}
+
+void ChirpZ::powerPair(const double *in1, const double *in2, int stride,
+                       ChirpZWorkspace &ws, double *out1, double *out2) const {
+  const int half = (m_points + 1) / 2; // Index half - 1 liegt bei 0 Hz
+  if (!in2) {
+    convolve(in1, nullptr, stride, ws);
+    const Complex *a = ws.a.data();
+    for (int m = 0; m < half; ++m)
+      out1[m] = std::norm(a[half - 1 + m]);
+    return;
+  }
+
+  // Z = X1 + i X2 mit X(-f) = conj X(f):
+  // X1(f) = (Z(f) + conj Z(-f)) / 2, X2(f) = (Z(f) - conj Z(-f)) / 2i
+  convolve(in1, in2, stride, ws);
+  const Complex *a = ws.a.data();
+  const Complex *post = m_post.constData();
+  for (int m = 0; m < half; ++m) {
+    const int pos = half - 1 + m;
+    const int neg = half - 1 - m;
+    const Complex zp = post[pos] * std::conj(a[pos]);
+    const Complex zn = std::conj(post[neg] * std::conj(a[neg]));
+    out1[m] = 0.25 * std::norm(zp + zn);
+    out2[m] = 0.25 * std::norm(zp - zn);
+  }
+}
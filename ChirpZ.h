@@ -0,0 +1,87 @@
+#ifndef CHIRPZ_H
+#define CHIRPZ_H
+
+#include "FftPlan.h"
+
+#include <QVector>
+#include <complex>
+#include <memory>
+
+struct ChirpZWorkspace;
+
+/**
+ * Chirp-Z-Transformation (Bluestein) für reelle Segmente der Länge N.
+ *
+ * Wertet die DTFT nur auf einem Frequenzraster f_m = startHz + m * stepHz
+ * (m < points) aus, z.B. 0..30 Hz in 0,05-Hz-Schritten, statt alle N/2+1
+ * Bins bis fs/2 zu rechnen oder für dieselbe Rasterweite auf fs/stepHz
+ * Punkte aufzufüllen. Kosten: zwei komplexe FFTs der Länge P >= N + M - 1.
+ *
+ * Chirps und das Spektrum des Faltungskerns werden einmal pro
+ * (N, fs, Raster) berechnet; forSpec() liefert gecachte, threadsicher
+ * teilbare Instanzen.
+ *
+ * Für reelle Eingaben bei 0 Hz beginnende Raster: symmetric() legt das
+ * Raster von -maxHz bis +maxHz, powerPair() transformiert damit zwei
+ * Kanäle als x1 + i x2 in einem Durchgang (X(-f) = conj X(f)).
+ */
+class ChirpZ {
+public:
+  using Complex = std::complex<double>;
+
+  ChirpZ(int n, double sampleRate, double startHz, double stepHz, int points);
+
+  /// Gecachte Transformation (threadsicher)
+  static std::shared_ptr<const ChirpZ> forSpec(int n, double sampleRate,
+                                               double startHz, double stepHz,
+                                               int points);
+  /// Gecachtes Raster -(halfPoints-1)*stepHz .. +(halfPoints-1)*stepHz
+  static std::shared_ptr<const ChirpZ> symmetric(int n, double sampleRate,
+                                                 double stepHz, int halfPoints);
+
+  int size() const { return m_n; }
+  int points() const { return m_points; }
+  int fftLength() const { return m_fftLen; }
+  double startHz() const { return m_startHz; }
+  double stepHz() const { return m_stepHz; }
+
+  /// in[i * stride], i < N -> out[m] = sum x[n] e^{-2pi i f_m n / fs}
+  void transform(const double *in, int stride, ChirpZWorkspace &ws,
+                 Complex *out) const;
+  /// Wie transform(), aber |X(f_m)|^2
+  void power(const double *in, int stride, ChirpZWorkspace &ws,
+             double *out) const;
+
+  /// Nur symmetric(): |X1|^2, |X2|^2 an den halfPoints Frequenzen >= 0
+  /// (in2 = nullptr -> nur X1)
+  void powerPair(const double *in1, const double *in2, int stride,
+                 ChirpZWorkspace &ws, double *out1, double *out2) const;
+
+private:
+  void convolve(const double *re, const double *im, int stride,
+                ChirpZWorkspace &ws) const;
+
+  int m_n = 0;
+  int m_points = 0;
+  int m_fftLen = 0; // P
+  double m_startHz = 0.0;
+  double m_stepHz = 0.0;
+
+  std::shared_ptr<const FftPlan> m_plan; // komplexe Länge P
+  QVector<Complex> m_pre;    // e^{-2pi i f0 n/fs} e^{-i a n^2}, n < N
+  QVector<Complex> m_post;   // e^{-i a m^2}, m < M
+  QVector<Complex> m_kernel; // FFT(e^{i a k^2}) / P
+};
+
+/// Arbeitspuffer für ChirpZ (Länge P)
+struct ChirpZWorkspace {
+  AlignedBuffer<ChirpZ::Complex> a;
+  AlignedBuffer<ChirpZ::Complex> b;
+
+  void ensure(int fftLength) {
+    a.resize(fftLength);
+    b.resize(fftLength);
+  }
+};
+
+#endif // CHIRPZ_H
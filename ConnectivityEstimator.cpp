@@ -0,0 +1,263 @@
+#include "ConnectivityEstimator.h"
+#include "WelchEstimator.h"
+
+#include <QThread>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Darunter (Paare x Bins) lohnt das Verteilen auf Threads nicht
+constexpr int kParallelWork = 16384;
+} // namespace
+
+double ConnectivityEstimator::Matrix::value(Measure measure, int band, int i,
+                                            int j) const {
+  if (i < 0 || j < 0 || i >= m_channels || j >= m_channels || m_bands == 0)
+    return 0.0;
+  if (i == j)
+    return 1.0;
+  if (i > j)
+    std::swap(i, j);
+
+  const int pairs = m_channels * (m_channels - 1) / 2;
+  const int p = i * m_channels - i * (i + 1) / 2 + (j - i - 1);
+  const QVector<double> &v =
+      (measure == Measure::Coherence) ? m_coherence : m_plv;
+  if (band >= 0)
+    return band < m_bands ? v[band * pairs + p] : 0.0;
+
+  double sum = 0.0;
+  for (int b = 0; b < m_bands; ++b)
+    sum += v[b * pairs + p];
+  return sum / double(m_bands);
+}
+
+QVector<double> ConnectivityEstimator::Matrix::matrix(Measure measure,
+                                                      int band) const {
+  const int C = m_channels;
+  QVector<double> m(C * C, 0.0);
+  for (int i = 0; i < C; ++i)
+    for (int j = 0; j < C; ++j)
+      m[i * C + j] = value(measure, band, i, j);
+  return m;
+}
+
+ConnectivityEstimator::ConnectivityEstimator(int numChannels, int averages)
+    : m_numChannels(std::max(0, numChannels)),
+      m_averages(std::max(1, averages)),
+      m_bands(BandPowerTracker::defaultBands()) {
+  for (int i = 0; i < m_numChannels; ++i) {
+    for (int j = i + 1; j < m_numChannels; ++j) {
+      m_pairI.append(i);
+      m_pairJ.append(j);
+    }
+  }
+  setMaxThreads(QThread::idealThreadCount());
+}
+
+void ConnectivityEstimator::setBands(const QVector<Band> &bands) {
+  m_bands = bands;
+  m_mappedBins = 0; // Zuordnung beim nächsten Segment neu aufbauen
+  reset();
+}
+
+void ConnectivityEstimator::setAverages(int averages) {
+  m_averages = std::max(1, averages);
+}
+
+void ConnectivityEstimator::setMaxThreads(int threads) {
+  m_maxThreads = std::max(1, threads);
+  // Der aufrufende Thread rechnet selbst einen Block mit
+  m_pool.setMaxThreadCount(std::max(1, m_maxThreads - 1));
+}
+
+void ConnectivityEstimator::reset() {
+  m_auto.fill(0.0);
+  m_crossRe.fill(0.0);
+  m_crossIm.fill(0.0);
+  m_phaseRe.fill(0.0);
+  m_phaseIm.fill(0.0);
+  m_averaged = 0;
+}
+
+void ConnectivityEstimator::mapBins(int bins, double binHz) {
+  // Gleiche Zuordnung wie BandPowerMatrix: low <= f < high
+  auto firstBinAt = [&](double hz) {
+    return qBound(0, int(std::ceil(hz / binHz)), bins);
+  };
+  const int B = m_bands.size();
+  QVector<int> lo(B), hi(B);
+  int begin = bins, end = 0;
+  for (int b = 0; b < B; ++b) {
+    lo[b] = firstBinAt(m_bands[b].lowHz);
+    hi[b] = std::max(lo[b], firstBinAt(m_bands[b].highHz));
+    if (hi[b] > lo[b]) {
+      begin = std::min(begin, lo[b]);
+      end = std::max(end, hi[b]);
+    }
+  }
+  m_binBegin = std::min(begin, end);
+  m_width = end - m_binBegin;
+  m_binLo.resize(B);
+  m_binHi.resize(B);
+  for (int b = 0; b < B; ++b) {
+    m_binLo[b] = std::max(0, lo[b] - m_binBegin);
+    m_binHi[b] = std::max(m_binLo[b], hi[b] - m_binBegin);
+  }
+  m_mappedBins = bins;
+  m_mappedBinHz = binHz;
+
+  const int W = m_width;
+  const int C = m_numChannels;
+  const int P = pairCount();
+  m_xRe.resize(C * W);
+  m_xIm.resize(C * W);
+  m_uRe.resize(C * W);
+  m_uIm.resize(C * W);
+  m_auto.resize(C * W);
+  m_crossRe.resize(P * W);
+  m_crossIm.resize(P * W);
+  m_phaseRe.resize(P * W);
+  m_phaseIm.resize(P * W);
+  reset();
+}
+
+void ConnectivityEstimator::forPairs(const std::function<void(int, int)> &fn) {
+  const int P = pairCount();
+  const int chunks =
+      (qint64(P) * m_width < kParallelWork) ? 1 : std::min(m_maxThreads, P);
+  if (chunks <= 1) {
+    fn(0, P);
+    return;
+  }
+
+  // Gleich große Paar-Blöcke; der letzte läuft im aufrufenden Thread
+  for (int c = 0; c < chunks - 1; ++c) {
+    const int begin = int(qint64(P) * c / chunks);
+    const int end = int(qint64(P) * (c + 1) / chunks);
+    m_pool.start([&fn, begin, end]() { fn(begin, end); });
+  }
+  fn(int(qint64(P) * (chunks - 1) / chunks), P);
+  m_pool.waitForDone();
+}
+
+bool ConnectivityEstimator::addSegment(const WelchEstimator &estimator) {
+  if (!estimator.hasSpectra() || estimator.channels() < m_numChannels ||
+      m_numChannels < 2 || m_bands.isEmpty())
+    return false;
+  if (estimator.bins() != m_mappedBins ||
+      estimator.binHz() != m_mappedBinHz)
+    mapBins(estimator.bins(), estimator.binHz());
+
+  const int C = m_numChannels;
+  const int W = m_width;
+  if (W == 0)
+    return false;
+
+  // Bandbereich je Kanal zusammenhängend kopieren, Einheitsphasoren dazu
+  for (int c = 0; c < C; ++c) {
+    const double *re = estimator.spectrumRe(c) + m_binBegin;
+    const double *im = estimator.spectrumIm(c) + m_binBegin;
+    double *xr = m_xRe.data() + c * W;
+    double *xi = m_xIm.data() + c * W;
+    double *ur = m_uRe.data() + c * W;
+    double *ui = m_uIm.data() + c * W;
+    for (int k = 0; k < W; ++k) {
+      xr[k] = re[k];
+      xi[k] = im[k];
+      const double mag = std::sqrt(re[k] * re[k] + im[k] * im[k]);
+      const double inv = mag > 0.0 ? 1.0 / mag : 0.0;
+      ur[k] = re[k] * inv;
+      ui[k] = im[k] * inv;
+    }
+  }
+
+  // Bis zur vollen Tiefe arithmetisch, danach exponentiell
+  const double alpha = 1.0 / double(std::min(m_averaged + 1, m_averages));
+
+  for (int c = 0; c < C; ++c) {
+    const double *xr = m_xRe.constData() + c * W;
+    const double *xi = m_xIm.constData() + c * W;
+    double *s = m_auto.data() + c * W;
+    for (int k = 0; k < W; ++k)
+      s[k] += alpha * (xr[k] * xr[k] + xi[k] * xi[k] - s[k]);
+  }
+
+  forPairs([this, alpha, W](int begin, int end) {
+    for (int p = begin; p < end; ++p) {
+      const int i = m_pairI[p];
+      const int j = m_pairJ[p];
+      const double *xir = m_xRe.constData() + i * W;
+      const double *xii = m_xIm.constData() + i * W;
+      const double *xjr = m_xRe.constData() + j * W;
+      const double *xji = m_xIm.constData() + j * W;
+      const double *uir = m_uRe.constData() + i * W;
+      const double *uii = m_uIm.constData() + i * W;
+      const double *ujr = m_uRe.constData() + j * W;
+      const double *uji = m_uIm.constData() + j * W;
+      double *sr = m_crossRe.data() + p * W;
+      double *si = m_crossIm.data() + p * W;
+      double *pr = m_phaseRe.data() + p * W;
+      double *pi = m_phaseIm.data() + p * W;
+      for (int k = 0; k < W; ++k) {
+        // X_i X_j* und u_i u_j*
+        const double cr = xir[k] * xjr[k] + xii[k] * xji[k];
+        const double ci = xii[k] * xjr[k] - xir[k] * xji[k];
+        const double qr = uir[k] * ujr[k] + uii[k] * uji[k];
+        const double qi = uii[k] * ujr[k] - uir[k] * uji[k];
+        sr[k] += alpha * (cr - sr[k]);
+        si[k] += alpha * (ci - si[k]);
+        pr[k] += alpha * (qr - pr[k]);
+        pi[k] += alpha * (qi - pi[k]);
+      }
+    }
+  });
+
+  m_averaged = std::min(m_averaged + 1, m_averages);
+  return true;
+}
+
+ConnectivityEstimator::Matrix ConnectivityEstimator::compute() {
+  Matrix m;
+  if (!isReady() || m_numChannels < 2)
+    return m;
+
+  const int B = m_bands.size();
+  const int P = pairCount();
+  const int W = m_width;
+  m.m_channels = m_numChannels;
+  m.m_bands = B;
+  m.m_coherence.fill(0.0, B * P);
+  m.m_plv.fill(0.0, B * P);
+  double *coh = m.m_coherence.data();
+  double *plv = m.m_plv.data();
+
+  forPairs([&](int begin, int end) {
+    for (int p = begin; p < end; ++p) {
+      const double *si = m_auto.constData() + m_pairI[p] * W;
+      const double *sj = m_auto.constData() + m_pairJ[p] * W;
+      const double *cr = m_crossRe.constData() + p * W;
+      const double *ci = m_crossIm.constData() + p * W;
+      const double *pr = m_phaseRe.constData() + p * W;
+      const double *pi = m_phaseIm.constData() + p * W;
+      for (int b = 0; b < B; ++b) {
+        const int lo = m_binLo[b];
+        const int hi = m_binHi[b];
+        if (hi <= lo)
+          continue;
+        double sumCoh = 0.0, sumPlv = 0.0;
+        for (int k = lo; k < hi; ++k) {
+          const double den = si[k] * sj[k];
+          if (den > 0.0)
+            sumCoh += (cr[k] * cr[k] + ci[k] * ci[k]) / den;
+          sumPlv += std::sqrt(pr[k] * pr[k] + pi[k] * pi[k]);
+        }
+        const double inv = 1.0 / double(hi - lo);
+        coh[b * P + p] = qBound(0.0, sumCoh * inv, 1.0);
+        plv[b * P + p] = qBound(0.0, sumPlv * inv, 1.0);
+      }
+    }
+  });
+  return m;
+}
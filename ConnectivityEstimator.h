@@ -0,0 +1,122 @@
+#ifndef CONNECTIVITYESTIMATOR_H
+#define CONNECTIVITYESTIMATOR_H
+
+#include "BandPowerTracker.h"
+
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include <functional>
+
+class WelchEstimator;
+
+/**
+ * Konnektivität zwischen allen Kanalpaaren: Magnitude-Squared Coherence
+ * und Phase-Locking Value (PLV), je Band gemittelt.
+ *
+ * Kein eigener FFT-Durchlauf: addSegment() übernimmt die komplexen Bins,
+ * die der Mehrkanal-WelchEstimator pro Segment ohnehin rechnet
+ * (setKeepSpectra). Pro Segment werden nur die Bins innerhalb der Bänder
+ * in die Kreuzspektren S_ij = E[X_i X_j*] und die Phasenmittel
+ * E[X_i X_j* / |X_i X_j|] eingerechnet (exponentiell, Tiefe averages);
+ * daraus ergeben sich
+ *   Kohärenz  |S_ij|^2 / (S_ii S_jj)
+ *   PLV       |E[e^{i(phi_i - phi_j)}]|
+ * Die O(C^2)-Paarschleifen laufen in Paar-Blöcken auf mehreren Kernen,
+ * innen jeweils zusammenhängend über die Bins (vektorisierbar).
+ */
+class ConnectivityEstimator
+{
+public:
+    using Band = BandPowerTracker::Band;
+    enum class Measure { Coherence, Plv };
+
+    /// Bandgemittelte Werte aller Paare (wertartig, für Ergebnis-Snapshots)
+    class Matrix
+    {
+    public:
+        bool isValid() const { return m_channels > 1; }
+        int channelCount() const { return m_channels; }
+        int bandCount() const { return m_bands; }
+
+        /// 0..1, symmetrisch, Diagonale 1; band = -1 -> Mittel aller Bänder
+        double value(Measure measure, int band, int i, int j) const;
+        /// channels x channels, zeilenweise
+        QVector<double> matrix(Measure measure, int band) const;
+
+    private:
+        friend class ConnectivityEstimator;
+
+        int m_channels = 0;
+        int m_bands    = 0;
+        QVector<double> m_coherence;  // [band * pairs + pair]
+        QVector<double> m_plv;
+    };
+
+    explicit ConnectivityEstimator(int numChannels, int averages = 8);
+
+    void setBands(const QVector<Band> &bands);
+    const QVector<Band> &bands() const { return m_bands; }
+    /// Mitteltiefe (1/alpha; bis dahin arithmetisches Mittel)
+    void setAverages(int averages);
+    /// Kerne für die Paarschleifen (1 = nur aufrufender Thread)
+    void setMaxThreads(int threads);
+
+    void reset();
+
+    /// Jüngstes Segment aus estimator.spectrumRe/Im einrechnen; false, wenn
+    /// er keine Spektren liefert (setKeepSpectra, kein Zoom-Modus)
+    bool addSegment(const WelchEstimator &estimator);
+
+    int  segmentsAveraged() const { return m_averaged; }
+    /// Erst nach mehreren Segmenten: aus einem einzelnen sind Kohärenz und
+    /// PLV für jedes Paar exakt 1
+    bool isReady() const
+    {
+        return m_averaged >= std::min(m_averages, kMinSegments);
+    }
+
+    /// Bandmittel des aktuellen Stands (ungültig, solange nicht bereit)
+    Matrix compute();
+
+private:
+    void mapBins(int bins, double binHz);
+    int pairCount() const { return m_pairI.size(); }
+    /// fn(begin, end) über Paarbereiche, ab genug Arbeit parallel
+    void forPairs(const std::function<void(int, int)> &fn);
+
+    static constexpr int kMinSegments = 4; // vor der ersten Matrix
+
+    int m_numChannels = 0;
+    int m_averages    = 8;
+    int m_maxThreads  = 1;
+    QVector<Band> m_bands;
+    QThreadPool m_pool;
+
+    // Paar p = (m_pairI[p], m_pairJ[p]), i < j
+    QVector<int> m_pairI;
+    QVector<int> m_pairJ;
+
+    // Bins [m_binBegin, m_binBegin + m_width) decken alle Bänder ab;
+    // Band b: [m_binLo[b], m_binHi[b]) relativ zu m_binBegin
+    QVector<int> m_binLo;
+    QVector<int> m_binHi;
+    int    m_binBegin    = 0;
+    int    m_width       = 0;
+    int    m_mappedBins  = 0;
+    double m_mappedBinHz = 0.0;
+
+    // Aktuelles Segment je Kanal [channel * width + k]
+    QVector<double> m_xRe, m_xIm;     // X
+    QVector<double> m_uRe, m_uIm;     // X / |X|
+
+    // Mittelwerte
+    QVector<double> m_auto;           // S_ii [channel * width + k]
+    QVector<double> m_crossRe;        // S_ij [pair * width + k]
+    QVector<double> m_crossIm;
+    QVector<double> m_phaseRe;        // E[u_i u_j*] [pair * width + k]
+    QVector<double> m_phaseIm;
+    int m_averaged = 0;
+};
+
+#endif // CONNECTIVITYESTIMATOR_H
@@ -21,6 +21,12 @@ void DummyDataSource::start() {
 
 void DummyDataSource::stop() { timer->stop(); }
 
+void DummyDataSource::setLeadOffExcitation(bool on) {
+  AbstractDataSource::setLeadOffExcitation(on);
+  // Simulierte Firmware: bestätigt sofort mit "LOFF:<0|1>"
+  handleResponse(on ? "LOFF:1" : "LOFF:0");
+}
+
 void DummyDataSource::generateData() {
   double dt = 1.0 / 250.0; // 0.004
   qint64 elapsedMs = m_elapsedTimer.elapsed();
@@ -50,10 +56,17 @@ void DummyDataSource::generateData() {
           (QRandomGenerator::global()->generateDouble() - 0.5) * 10.0;
 
       double value = baseSignal + drift + hum + highFreq + whiteNoise;
+
+      // 6. AC-Lead-Off-Anregung (31.25 Hz) - simuliert 5..40 kOhm Impedanz
+      if (leadOffExcitationEnabled()) {
+        double ohm = 2200.0 + (5.0 + 5.0 * i) * 1000.0;
+        double amp = ohm * (4.0 / M_PI * 6.0e-9) * 1e6; // µV
+        value += amp * qSin(2 * M_PI * 31.25 * time);
+      }
       values.append(value);
     }
 
-    emit newEEGData(values);
+    publishSample(values);
     time += dt;
     m_samplesGenerated++;
   }
@@ -16,6 +16,7 @@ public:
   void start();
   void stop() override;
   double sampleRate() const override;
+  void setLeadOffExcitation(bool on) override;
 
 private slots:
   void generateData();
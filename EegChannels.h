@@ -0,0 +1,21 @@
+#ifndef EEGCHANNELS_H
+#define EEGCHANNELS_H
+
+#include <QString>
+#include <QStringList>
+
+/// Elektroden der Kanäle nach dem 10-20-System, in Kanalreihenfolge
+inline const QStringList &eegChannelLabels()
+{
+    static const QStringList labels = {"Fp1", "Fp2", "F7", "F8",
+                                       "Fz",  "Pz",  "T5", "T6"};
+    return labels;
+}
+
+/// Beschriftung von Kanal ch (ChN für Kanäle ohne Elektrode)
+inline QString eegChannelLabel(int ch)
+{
+    return eegChannelLabels().value(ch, QString("Ch%1").arg(ch + 1));
+}
+
+#endif // EEGCHANNELS_H
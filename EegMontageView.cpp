@@ -0,0 +1,452 @@
+#include "EegMontageView.h"
+
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QPen>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kLabelWidth = 44;  // linker Rand für die Kanalnamen
+constexpr int kAxisHeight = 18;  // unterer Rand für die Zeitachse
+constexpr double kAutoMargin = 1.1;
+constexpr double kAutoHeadroom = 1.25; // Reserve beim Nachführen der Autoskala
+constexpr double kSweepGap = 0.02; // Löschbalken vor dem Cursor (Anteil)
+
+// Abrunden auch für negative Spaltenindizes (Fenster noch nicht gefüllt)
+qint64 floorDiv(qint64 a, qint64 b) {
+  const qint64 q = a / b;
+  return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+qint64 floorMod(qint64 a, qint64 b) { return a - floorDiv(a, b) * b; }
+} // namespace
+
+EegMontageView::EegMontageView(QWidget *parent) : QWidget(parent) {
+  setAttribute(Qt::WA_OpaquePaintEvent);
+  setMinimumSize(200, 160);
+}
+
+void EegMontageView::setChannels(const QStringList &labels,
+                                 const QVector<QColor> &colors) {
+  m_channels = labels.size();
+  m_envelope.setChannels(m_channels);
+  m_labels = labels;
+  m_colors = colors;
+  m_colors.resize(m_channels);
+  m_scales.fill(0.0, m_channels);
+  m_autoCenter.fill(0.0, m_channels);
+  m_autoHalf.fill(0.0, m_channels);
+  m_staticLayer = QImage(); // Kanalnamen neu zeichnen
+  allocate();
+}
+
+void EegMontageView::setWindowSeconds(double seconds) {
+  if (seconds <= 0.0 || seconds == m_windowSec)
+    return;
+  m_windowSec = seconds;
+  allocate();
+}
+
+void EegMontageView::setChannelScale(int channel, double halfRangeUv) {
+  if (channel < 0 || channel >= m_channels)
+    return;
+  m_scales[channel] = std::max(0.0, halfRangeUv);
+  invalidate();
+}
+
+void EegMontageView::setAllScales(double halfRangeUv) {
+  m_scales.fill(std::max(0.0, halfRangeUv));
+  invalidate();
+}
+
+void EegMontageView::setRenderMode(RenderMode mode) {
+  if (mode == m_mode)
+    return;
+  m_mode = mode;
+  invalidate();
+}
+
+void EegMontageView::invalidate() {
+  m_fullRedraw = true;
+  update();
+}
+
+void EegMontageView::allocate() {
+  m_capacity = (m_dt > 0.0) ? int(std::ceil(m_windowSec / m_dt)) + 1 : 0;
+  m_ring.fill(0.0, m_capacity * m_channels);
+  m_envelope.configure(1.0, 0); // beim nächsten Zeichnen neu aufbauen
+  m_ranges.resize(m_channels);
+  for (SlidingRange &range : m_ranges)
+    range.configure(m_capacity);
+  clear();
+}
+
+void EegMontageView::clear() {
+  m_writePos = 0;
+  m_filled = 0;
+  m_totalFrames = 0;
+  m_scaledUpTo = 0;
+  m_envelope.reset();
+  for (SlidingRange &range : m_ranges)
+    range.reset();
+  m_autoHalf.fill(0.0);
+  invalidate();
+}
+
+void EegMontageView::appendFrames(const double *interleaved, int frames,
+                                  int stride, double startTime, double dt) {
+  if (frames <= 0 || dt <= 0.0 || m_channels == 0)
+    return;
+  if (std::abs(dt - m_dt) > 1e-9 * dt) {
+    m_dt = dt;
+    allocate();
+  } else if (m_filled > 0 && startTime < m_lastTime) {
+    clear(); // Zeit läuft rückwärts: neue Aufnahme
+  }
+  if (m_totalFrames == 0)
+    m_timeOrigin = startTime;
+
+  const int C = m_channels;
+  const int copy = std::min(C, stride);
+  for (int f = 0; f < frames; ++f) {
+    const double *src = interleaved + f * stride;
+    double *dst = m_ring.data() + m_writePos * C;
+    std::copy(src, src + copy, dst);
+    std::fill(dst + copy, dst + C, 0.0);
+    if (++m_writePos >= m_capacity)
+      m_writePos = 0;
+  }
+  m_filled = std::min(m_filled + frames, m_capacity);
+  m_lastTime = startTime + (frames - 1) * dt;
+
+  // Hüllkurve mitführen: nur die jüngsten Spalten ändern sich
+  if (m_envelope.isConfigured())
+    m_envelope.append(interleaved, frames, stride, m_totalFrames);
+  for (int c = 0; c < C; ++c) {
+    if (c < copy) {
+      m_ranges[c].append(interleaved + c, frames, stride);
+    } else {
+      for (int f = 0; f < frames; ++f)
+        m_ranges[c].append(0.0);
+    }
+  }
+  m_totalFrames += frames;
+}
+
+double EegMontageView::sampleAt(qint64 index, int channel) const {
+  int pos = m_writePos - int(m_totalFrames - index);
+  if (pos < 0)
+    pos += m_capacity;
+  return m_ring[pos * m_channels + channel];
+}
+
+qint64 EegMontageView::columnOfSample(qint64 index) const {
+  return qint64(std::floor(double(index) / m_samplesPerColumn));
+}
+
+qint64 EegMontageView::columnOfTime(double t) const {
+  return qint64(
+      std::floor((t - m_timeOrigin) / m_dt / m_samplesPerColumn + 1e-9));
+}
+
+QRect EegMontageView::traceArea() const {
+  return QRect(kLabelWidth, 2, width() - kLabelWidth - 4,
+               height() - kAxisHeight - 2);
+}
+
+int EegMontageView::sweepGap() const {
+  return std::max(4, int(m_traceLayer.width() * kSweepGap));
+}
+
+bool EegMontageView::prepareEnvelope(int columns) {
+  const double samplesPerColumn = m_windowSec / m_dt / columns;
+  if (samplesPerColumn <= 2.0)
+    return false;
+  if (m_envelope.matches(samplesPerColumn, columns))
+    return true;
+
+  // Zoom/Größenänderung: einmal aus dem Ring aufbauen (älteste zuerst)
+  m_envelope.configure(samplesPerColumn, columns);
+  const int C = m_channels;
+  int first = m_writePos - m_filled;
+  if (first < 0)
+    first += m_capacity;
+  const int head = std::min(m_filled, m_capacity - first);
+  const qint64 firstIndex = m_totalFrames - m_filled;
+  m_envelope.append(m_ring.constData() + first * C, head, C, firstIndex);
+  m_envelope.append(m_ring.constData(), m_filled - head, C, firstIndex + head);
+  return true;
+}
+
+void EegMontageView::rebuildStaticLayer() {
+  m_staticLayer = QImage(size(), QImage::Format_RGB32);
+  m_staticLayer.fill(Qt::white);
+  m_fullRedraw = true;
+
+  const QRectF area = traceArea();
+  if (area.width() < 2 || area.height() < 2 || m_channels == 0)
+    return;
+
+  QPainter painter(&m_staticLayer);
+  QFont font = painter.font();
+  font.setPixelSize(10);
+  painter.setFont(font);
+  const double laneH = area.height() / m_channels;
+  for (int c = 0; c < m_channels; ++c) {
+    painter.setPen(m_colors[c].isValid() ? m_colors[c] : QColor(Qt::black));
+    painter.drawText(QRectF(0, area.top() + c * laneH, kLabelWidth - 4, laneH),
+                     Qt::AlignRight | Qt::AlignVCenter, m_labels.value(c));
+  }
+  painter.setPen(Qt::black);
+  painter.drawLine(area.bottomLeft(), area.bottomRight());
+}
+
+void EegMontageView::paintEvent(QPaintEvent *) {
+  QElapsedTimer timer;
+  timer.start();
+  m_lastDirtyColumns = 0;
+
+  if (m_staticLayer.size() != size())
+    rebuildStaticLayer();
+
+  QPainter painter(this);
+  painter.drawImage(0, 0, m_staticLayer);
+
+  const QRect area = traceArea();
+  if (area.width() < 2 || area.height() < 2 || m_channels == 0)
+    return;
+
+  if (m_filled > 0) {
+    updateTraceLayer(area.size());
+    const int W = area.width();
+    if (m_mode == ScrollMode) {
+      // Älteste sichtbare Spalte links, jüngste rechts: zwei Teilbilder
+      const int split = int(floorMod(m_drawnColumn + 1, W));
+      painter.drawImage(area.left(), area.top(), m_traceLayer, split, 0,
+                        W - split, area.height());
+      if (split > 0)
+        painter.drawImage(area.left() + W - split, area.top(), m_traceLayer,
+                          0, 0, split, area.height());
+    } else {
+      painter.drawImage(area.topLeft(), m_traceLayer);
+    }
+  }
+  drawTimeAxis(painter, area);
+
+  m_lastPaintMs = timer.nsecsElapsed() / 1e6;
+}
+
+void EegMontageView::updateTraceLayer(const QSize &size) {
+  const int W = size.width();
+  const double samplesPerColumn = m_windowSec / m_dt / W;
+  if (m_traceLayer.size() != size || samplesPerColumn != m_samplesPerColumn) {
+    m_traceLayer = QImage(size, QImage::Format_RGB32);
+    m_samplesPerColumn = samplesPerColumn;
+    m_fullRedraw = true;
+  }
+  m_useEnvelope = prepareEnvelope(W);
+  m_rescaled.fill(false, m_channels);
+  updateAutoScales();
+
+  // Neu: ab der zuletzt (evtl. halb) gezeichneten Spalte bis zur jüngsten;
+  // die Spalte davor enthält die Verbindungslinie zu ihr
+  const qint64 newest = columnOfSample(m_totalFrames - 1);
+  const int gap = (m_mode == SweepMode) ? sweepGap() : 0;
+  const qint64 oldest = newest - W + 1 + gap;
+  qint64 from = m_drawnColumn - 1;
+  if (m_fullRedraw || newest < m_drawnColumn ||
+      newest - m_drawnColumn >= W - gap) {
+    m_traceLayer.fill(Qt::white);
+    from = oldest;
+    m_fullRedraw = false;
+  } else {
+    // Neu skalierte Kanäle: nur deren Streifen komplett neu
+    for (int c = 0; c < m_channels; ++c)
+      if (m_rescaled[c])
+        renderColumns(oldest, from - 1, true, c);
+  }
+  renderColumns(from, newest, true);
+  if (gap > 0)
+    renderColumns(newest + 1, newest + gap, false); // Löschbalken
+  m_drawnColumn = newest;
+  m_lastDirtyColumns = int(newest - from + 1) + gap;
+}
+
+void EegMontageView::updateAutoScales() {
+  const qint64 from = std::max(m_scaledUpTo, m_totalFrames - m_filled);
+  const int fresh = int(m_totalFrames - from);
+  const int second = int(std::floor(m_lastTime));
+  const bool periodic = second != m_scaleCheckSecond;
+  m_scaleCheckSecond = second;
+  m_scaledUpTo = m_totalFrames;
+
+  for (int c = 0; c < m_channels; ++c) {
+    if (m_scales[c] > 0.0 || m_ranges[c].isEmpty())
+      continue;
+    const double center = m_autoCenter[c];
+    const double half = m_autoHalf[c];
+
+    // Nur die neuen Samples gegen die aktuelle Skala prüfen
+    bool overflow = half <= 0.0;
+    if (!overflow && fresh > 0) {
+      double lo = 0.0, hi = 0.0;
+      m_ranges[c].rangeOfLast(fresh, lo, hi);
+      overflow = lo < center - half || hi > center + half;
+    }
+    if (!overflow && !periodic)
+      continue;
+
+    double lo = 0.0, hi = 0.0;
+    windowRange(c, lo, hi);
+    // Überlauf nur durch Ausreißer: die robuste Spanne passt noch
+    if (overflow && half > 0.0 && lo >= center - half && hi <= center + half)
+      overflow = false;
+    const double newHalf = std::max(0.5 * (hi - lo), 1e-6) * kAutoMargin;
+    // Verkleinern erst, wenn die Spur weniger als die halbe Höhe nutzt
+    if (overflow || newHalf * kAutoHeadroom < 0.5 * half) {
+      m_autoCenter[c] = 0.5 * (lo + hi);
+      m_autoHalf[c] = newHalf * kAutoHeadroom;
+      m_rescaled[c] = true;
+    }
+  }
+}
+
+void EegMontageView::windowRange(int channel, double &lo, double &hi) const {
+  m_ranges[channel].robustRange(lo, hi);
+}
+
+QRect EegMontageView::laneRect(int channel) const {
+  // Ganzzahlige Grenzen: jede Bildzeile gehört genau einem Streifen
+  const int H = m_traceLayer.height();
+  const int top = channel * H / m_channels;
+  return QRect(0, top, m_traceLayer.width(),
+               (channel + 1) * H / m_channels - top);
+}
+
+void EegMontageView::renderColumns(qint64 from, qint64 to, bool withTraces,
+                                   int channel) {
+  if (to < from)
+    return;
+  const int W = m_traceLayer.width();
+  const QRect rows = (channel < 0) ? QRect(0, 0, W, m_traceLayer.height())
+                                   : laneRect(channel);
+  const int firstLane = (channel < 0) ? 0 : channel;
+  const int lastLane = (channel < 0) ? m_channels - 1 : channel;
+  const double secPerColumn = m_samplesPerColumn * m_dt;
+
+  QPainter painter(&m_traceLayer);
+  // Höchstens zwei Stücke: bis zum Bildrand und nach dem Umbruch
+  for (qint64 a = from; a <= to;) {
+    const qint64 offset = floorDiv(a, W) * W;
+    const qint64 b = std::min(to, offset + W - 1);
+    const QRect clip(int(a - offset), rows.top(), int(b - a + 1),
+                     rows.height());
+    painter.setClipRect(clip);
+    painter.fillRect(clip, Qt::white);
+
+    painter.setPen(QPen(QColor(235, 235, 235), 0));
+    for (int c = std::max(1, firstLane); c <= lastLane; ++c) {
+      const int y = laneRect(c).top();
+      painter.drawLine(QPointF(clip.left(), y), QPointF(clip.right() + 1, y));
+    }
+
+    if (withTraces) {
+      // Sekundengitter läuft mit den Daten mit
+      painter.setPen(QPen(QColor(225, 225, 225), 0));
+      const double t0 = m_timeOrigin + (a - 1) * secPerColumn;
+      const double t1 = m_timeOrigin + (b + 2) * secPerColumn;
+      for (double t = std::ceil(t0); t < t1; t += 1.0) {
+        const qint64 col = columnOfTime(t);
+        if (col < a || col > b)
+          continue;
+        const double x = col - offset + 0.5;
+        painter.drawLine(QPointF(x, rows.top()),
+                         QPointF(x, rows.top() + rows.height()));
+      }
+      for (int c = firstLane; c <= lastLane; ++c)
+        drawSpan(painter, c, clip & laneRect(c), a, b, offset);
+    }
+    a = b + 1;
+  }
+}
+
+void EegMontageView::drawSpan(QPainter &painter, int channel,
+                              const QRect &clip, qint64 from, qint64 to,
+                              qint64 offset) {
+  const bool fixed = m_scales[channel] > 0.0;
+  const double half = fixed ? m_scales[channel] : m_autoHalf[channel];
+  const double center = fixed ? 0.0 : m_autoCenter[channel];
+  if (half <= 0.0)
+    return;
+  const QRect lane = laneRect(channel);
+  const double yMid = lane.top() + 0.5 * lane.height();
+  const double yPerUv = 0.5 * lane.height() / half;
+  const qint64 oldest = m_totalFrames - m_filled;
+
+  m_points.clear();
+  if (m_useEnvelope) {
+    // Min/Max je Spalte, ab der Spalte davor (Anschluss an das Bestehende)
+    const qint64 first =
+        std::max({from - 1, m_envelope.firstColumn(), columnOfSample(oldest)});
+    const qint64 last = std::min(to, m_envelope.lastColumn());
+    for (qint64 j = first; j <= last; ++j) {
+      const double x = j - offset + 0.5;
+      m_points.append(
+          QPointF(x, yMid - (m_envelope.low(j, channel) - center) * yPerUv));
+      m_points.append(
+          QPointF(x, yMid - (m_envelope.high(j, channel) - center) * yPerUv));
+    }
+  } else {
+    // Weniger Samples als Spalten: Samples direkt, eines davor und danach
+    const qint64 first = std::max(
+        oldest, qint64(std::ceil(from * m_samplesPerColumn)) - 1);
+    const qint64 last = std::min(
+        m_totalFrames - 1, qint64(std::floor((to + 1) * m_samplesPerColumn)));
+    for (qint64 s = first; s <= last; ++s)
+      m_points.append(QPointF(s / m_samplesPerColumn - offset,
+                              yMid - (sampleAt(s, channel) - center) * yPerUv));
+  }
+  if (m_points.size() < 2)
+    return;
+
+  painter.save();
+  painter.setClipRect(clip);
+  painter.setPen(QPen(m_colors[channel].isValid() ? m_colors[channel]
+                                                  : QColor(Qt::black),
+                      0));
+  painter.drawPolyline(m_points.constData(), m_points.size());
+  painter.restore();
+}
+
+void EegMontageView::drawTimeAxis(QPainter &painter, const QRect &area) {
+  QFont font = painter.font();
+  font.setPixelSize(10);
+  painter.setFont(font);
+  painter.setPen(Qt::black);
+
+  const int W = area.width();
+  auto label = [&](double x, int t) {
+    painter.drawText(QRectF(x - 20, area.bottom() + 3, 40, kAxisHeight - 2),
+                     Qt::AlignHCenter | Qt::AlignTop, QString("%1 s").arg(t));
+  };
+
+  if (m_filled == 0) {
+    // Noch keine Daten: Fenster 0 .. windowSeconds
+    for (int t = 0; t <= int(std::floor(m_windowSec)); ++t)
+      label(area.left() + t * W / m_windowSec, t);
+    return;
+  }
+
+  // Beschriftung an den Gitterlinien der Spurebene
+  const int gap = (m_mode == SweepMode) ? sweepGap() : 0;
+  const double tStart = m_lastTime - m_windowSec;
+  for (int t = int(std::ceil(tStart)); t <= int(std::floor(m_lastTime)); ++t) {
+    const qint64 age = m_drawnColumn - columnOfTime(t);
+    if (age < 0 || age >= W - gap)
+      continue;
+    const qint64 x = (m_mode == ScrollMode) ? W - 1 - age
+                                            : floorMod(columnOfTime(t), W);
+    label(area.left() + x + 0.5, t);
+  }
+}
@@ -0,0 +1,160 @@
+#ifndef EEGMONTAGEVIEW_H
+#define EEGMONTAGEVIEW_H
+
+#include "MinMaxEnvelope.h"
+#include "SlidingRange.h"
+
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QStringList>
+#include <QVector>
+#include <QWidget>
+
+class QPainter;
+
+/**
+ * Alle EEG-Kanäle gestapelt in einem Widget (Montage).
+ *
+ * Eine gemeinsame Zeitachse, je Kanal eine Spur mit eigenem Versatz und
+ * eigener Skala. Ersetzt N einzelne QCustomPlots: ein Layout, ein
+ * Achsen-/Gitterdurchlauf und ein paintEvent pro Frame statt N.
+ *
+ * Die Samples liegen in einem Ringpuffer über das Zeitfenster
+ * ([frame * channels + c], gleichmäßig im Abstand dt). Liegen mehr Samples
+ * als Pixelspalten im Fenster, wird die mitlaufende Min/Max-Hüllkurve je
+ * Pixelspalte gezeichnet (MinMaxEnvelope): neue Samples aktualisieren sie
+ * beim Anhängen, neu aufgebaut wird sie nur bei Größen- oder Fensteränderung.
+ *
+ * Gezeichnet wird inkrementell: Die Spuren liegen in einem Offscreen-Bild,
+ * in dem die absolute Pixelspalte j (Sample-Index / Samples pro Spalte) bei
+ * x = j mod Breite steht. Pro Frame werden nur die Spalten seit dem letzten
+ * Frame neu gezeichnet; der Rest bleibt stehen.
+ *  - ScrollMode: das Bild wird in zwei Teilen so ausgegeben, dass die
+ *    jüngste Spalte rechts steht (Verschieben ohne Pixel umzukopieren).
+ *  - SweepMode: klinische Darstellung, das Bild wird unverändert ausgegeben,
+ *    der Cursor läuft von links nach rechts und löscht einen schmalen
+ *    Balken vor sich.
+ * Kanalnamen und Achsenlinie liegen in einer eigenen, nur bei
+ * Größenänderung neu erzeugten Ebene. Ein Neuaufbau aller Spalten ist nur
+ * bei Größen-, Fenster- oder Modusänderung nötig. Die Autoskala passt sich
+ * mit Hysterese an (sofort beim Überlauf, verkleinert höchstens einmal pro
+ * Sekunde) und zeichnet dann nur den Streifen des Kanals neu.
+ *
+ * Den Wertebereich je Kanal führt SlidingRange beim Anhängen mit: Überlauf
+ * der neuen Samples per Min/Max-Deque, der Zielbereich aus den Block-Extrema
+ * ohne die extremsten Blöcke. Ein kurzer Elektroden-Pop vergrößert die Skala
+ * damit nicht, und die Kosten hängen nicht von Fensterlänge oder Abtastrate ab.
+ */
+class EegMontageView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum RenderMode { ScrollMode, SweepMode };
+
+    explicit EegMontageView(QWidget *parent = nullptr);
+
+    void setChannels(const QStringList &labels, const QVector<QColor> &colors);
+    int channelCount() const { return m_channels; }
+
+    /// Sichtbares Zeitfenster (Sekunden)
+    void setWindowSeconds(double seconds);
+    double windowSeconds() const { return m_windowSec; }
+
+    /// Halbe Spurhöhe in µV; 0 = Autoskala aus dem sichtbaren Fenster
+    void setChannelScale(int channel, double halfRangeUv);
+    void setAllScales(double halfRangeUv);
+
+    void setRenderMode(RenderMode mode);
+    RenderMode renderMode() const { return m_mode; }
+
+    /// frames Frames (Kanal c bei interleaved[f * stride + c]), erster Frame
+    /// zur Zeit startTime, Abstand dt; ein neues dt leert den Puffer
+    void appendFrames(const double *interleaved, int frames, int stride,
+                      double startTime, double dt);
+
+    void clear();
+
+    /// Dauer des letzten paintEvent (ms)
+    double lastPaintMs() const { return m_lastPaintMs; }
+    /// Im letzten paintEvent neu gezeichnete Pixelspalten
+    int lastDirtyColumns() const { return m_lastDirtyColumns; }
+
+    QSize sizeHint() const override { return QSize(600, 480); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void allocate();
+    /// Alle Spalten beim nächsten Zeichnen neu aufbauen
+    void invalidate();
+    QRect traceArea() const;
+
+    /// Sample mit laufendem Index (muss noch im Ring liegen)
+    double sampleAt(qint64 index, int channel) const;
+    qint64 columnOfSample(qint64 index) const;
+    qint64 columnOfTime(double t) const;
+
+    /// Hüllkurve passend zur Breite halten; false = Samples direkt zeichnen
+    bool prepareEnvelope(int columns);
+
+    void rebuildStaticLayer();
+    /// Spurebene auf den neuesten Stand bringen (nur geänderte Spalten)
+    void updateTraceLayer(const QSize &size);
+    /// Autoskalen prüfen; geänderte Kanäle in m_rescaled markieren
+    void updateAutoScales();
+    /// Autoskalenbereich über das Fenster (ohne kurze Ausreißer)
+    void windowRange(int channel, double &lo, double &hi) const;
+
+    QRect laneRect(int channel) const;
+    /// Absolute Spalten [from, to] ins Bild (ggf. über den Umbruch), nur
+    /// der Streifen von channel oder alle (-1)
+    void renderColumns(qint64 from, qint64 to, bool withTraces,
+                       int channel = -1);
+    void drawSpan(QPainter &painter, int channel, const QRect &clip,
+                  qint64 from, qint64 to, qint64 offset);
+    void drawTimeAxis(QPainter &painter, const QRect &area);
+    int sweepGap() const;
+
+    int    m_channels  = 0;
+    QStringList     m_labels;
+    QVector<QColor> m_colors;
+    QVector<double> m_scales;      // halbe Spurhöhe je Kanal, 0 = auto
+    QVector<double> m_autoCenter;  // aktuelle Autoskala je Kanal
+    QVector<double> m_autoHalf;    // 0 = noch nicht bestimmt
+    QVector<bool>   m_rescaled;    // Skala in diesem Frame geändert
+
+    double m_windowSec = 3.0;
+    double m_dt        = 0.0;
+    RenderMode m_mode  = ScrollMode;
+
+    // Ringpuffer über das Fenster
+    QVector<double> m_ring;        // [frame * channels + c]
+    int    m_capacity  = 0;        // Frames
+    int    m_writePos  = 0;
+    int    m_filled    = 0;
+    double m_lastTime  = 0.0;      // Zeit des jüngsten Frames
+    double m_timeOrigin = 0.0;     // Zeit zum laufenden Index 0
+    qint64 m_totalFrames = 0;      // laufender Index hinter dem jüngsten Frame
+
+    MinMaxEnvelope m_envelope;     // Min/Max je Pixelspalte, alle Kanäle
+    QVector<SlidingRange> m_ranges; // Min/Max über das Fenster je Kanal
+
+    // Inkrementelles Zeichnen
+    QImage m_staticLayer;          // Hintergrund, Kanalnamen, Achsenlinie
+    QImage m_traceLayer;           // Spuren, Spalte j bei x = j mod Breite
+    double m_samplesPerColumn = 0.0;
+    bool   m_useEnvelope = false;  // mehr als 2 Samples pro Spalte
+    qint64 m_drawnColumn = 0;      // jüngste gezeichnete (evtl. halbe) Spalte
+    qint64 m_scaledUpTo  = 0;      // bis hier gegen die Autoskala geprüft
+    int    m_scaleCheckSecond = 0;
+    bool   m_fullRedraw = true;
+
+    QVector<QPointF> m_points;     // Polylinie, wiederverwendet
+    double m_lastPaintMs = 0.0;
+    int    m_lastDirtyColumns = 0;
+};
+
+#endif // EEGMONTAGEVIEW_H
@@ -0,0 +1,482 @@
+#include "FftPlan.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Radizes in Stufenreihenfolge (4 bevorzugt), leer falls m nicht 5-glatt ist
+QVector<int> factorize(int m) {
+  QVector<int> radix;
+  while (m % 4 == 0) {
+    radix.append(4);
+    m /= 4;
+  }
+  for (int p : {2, 3, 5}) {
+    while (m % p == 0) {
+      radix.append(p);
+      m /= p;
+    }
+  }
+  if (m != 1)
+    radix.clear();
+  return radix;
+}
+
+// Eingangsreihenfolge für die iterative DIT: die letzte Stufe zerlegt in
+// Restklassen modulo ihres Radix, rekursiv bis zur Länge 1
+void digitReverse(const QVector<int> &idx, const QVector<int> &radix,
+                  int stages, QVector<int> &out) {
+  if (stages == 0) {
+    out += idx;
+    return;
+  }
+  const int p = radix[stages - 1];
+  const int len = idx.size() / p;
+  QVector<int> sub(len);
+  for (int r = 0; r < p; ++r) {
+    for (int j = 0; j < len; ++j)
+      sub[j] = idx[j * p + r];
+    digitReverse(sub, radix, stages - 1, out);
+  }
+}
+
+// -i * z
+inline FftPlan::Complex mulNegI(const FftPlan::Complex &z) {
+  return FftPlan::Complex(z.imag(), -z.real());
+}
+
+// Eine Stufe: p Teil-FFTs der Länge Lp -> eine der Länge L = p * Lp
+//   t_q = a[q Lp + j] W_L^{qj},  a[m Lp + j] = sum_q t_q W_p^{qm}
+template <int P>
+void radixStage(FftPlan::Complex *a, int M, int Lp,
+                const FftPlan::Complex *tw) {
+  using Complex = FftPlan::Complex;
+  static const double c3 = -0.5;
+  static const double s3 = std::sqrt(3.0) / 2.0;
+  static const double c51 = std::cos(2.0 * M_PI / 5.0);
+  static const double c52 = std::cos(4.0 * M_PI / 5.0);
+  static const double s51 = std::sin(2.0 * M_PI / 5.0);
+  static const double s52 = std::sin(4.0 * M_PI / 5.0);
+
+  const int L = Lp * P;
+  const int step = M / L; // W_L^k = tw[k * step]
+
+  for (int i = 0; i < M; i += L) {
+    Complex *x = a + i;
+    for (int j = 0; j < Lp; ++j) {
+      Complex t[P];
+      t[0] = x[j];
+      for (int q = 1; q < P; ++q)
+        t[q] = (j == 0) ? x[q * Lp + j] : x[q * Lp + j] * tw[q * j * step];
+
+      if constexpr (P == 2) {
+        x[j] = t[0] + t[1];
+        x[Lp + j] = t[0] - t[1];
+      } else if constexpr (P == 3) {
+        const Complex s = t[1] + t[2];
+        const Complex m = t[0] + c3 * s;
+        const Complex d = s3 * mulNegI(t[1] - t[2]);
+        x[j] = t[0] + s;
+        x[Lp + j] = m + d;
+        x[2 * Lp + j] = m - d;
+      } else if constexpr (P == 4) {
+        const Complex e0 = t[0] + t[2];
+        const Complex e1 = t[0] - t[2];
+        const Complex o0 = t[1] + t[3];
+        const Complex o1 = mulNegI(t[1] - t[3]);
+        x[j] = e0 + o0;
+        x[Lp + j] = e1 + o1;
+        x[2 * Lp + j] = e0 - o0;
+        x[3 * Lp + j] = e1 - o1;
+      } else {
+        const Complex a1 = t[1] + t[4], b1 = t[1] - t[4];
+        const Complex a2 = t[2] + t[3], b2 = t[2] - t[3];
+        const Complex m1 = t[0] + c51 * a1 + c52 * a2;
+        const Complex m2 = t[0] + c52 * a1 + c51 * a2;
+        const Complex d1 = mulNegI(s51 * b1 + s52 * b2);
+        const Complex d2 = mulNegI(s52 * b1 - s51 * b2);
+        x[j] = t[0] + a1 + a2;
+        x[Lp + j] = m1 + d1;
+        x[2 * Lp + j] = m2 + d2;
+        x[3 * Lp + j] = m2 - d2;
+        x[4 * Lp + j] = m1 - d1;
+      }
+    }
+  }
+}
+
+// Wie radixStage, aber für C Signale nebeneinander (SoA, Kanal innen):
+// Element i von Kanal c liegt bei re/im[i * C + c]. Die Twiddles sind für
+// alle Kanäle gleich, die innerste Schleife läuft über c.
+template <int P>
+void radixStageBatch(double *re, double *im, int M, int C, int Lp,
+                     const FftPlan::Complex *tw) {
+  static const double c3 = -0.5;
+  static const double s3 = std::sqrt(3.0) / 2.0;
+  static const double c51 = std::cos(2.0 * M_PI / 5.0);
+  static const double c52 = std::cos(4.0 * M_PI / 5.0);
+  static const double s51 = std::sin(2.0 * M_PI / 5.0);
+  static const double s52 = std::sin(4.0 * M_PI / 5.0);
+
+  const int L = Lp * P;
+  const int step = M / L;
+
+  for (int i = 0; i < M; i += L) {
+    for (int j = 0; j < Lp; ++j) {
+      double wr[P], wi[P];
+      for (int q = 0; q < P; ++q) {
+        wr[q] = tw[q * j * step].real();
+        wi[q] = tw[q * j * step].imag();
+      }
+
+      double *xr[P], *xi[P];
+      for (int q = 0; q < P; ++q) {
+        xr[q] = re + (i + q * Lp + j) * C;
+        xi[q] = im + (i + q * Lp + j) * C;
+      }
+
+      for (int c = 0; c < C; ++c) {
+        double tr[P], ti[P];
+        tr[0] = xr[0][c];
+        ti[0] = xi[0][c];
+        for (int q = 1; q < P; ++q) {
+          tr[q] = xr[q][c] * wr[q] - xi[q][c] * wi[q];
+          ti[q] = xr[q][c] * wi[q] + xi[q][c] * wr[q];
+        }
+
+        if constexpr (P == 2) {
+          xr[0][c] = tr[0] + tr[1];
+          xi[0][c] = ti[0] + ti[1];
+          xr[1][c] = tr[0] - tr[1];
+          xi[1][c] = ti[0] - ti[1];
+        } else if constexpr (P == 3) {
+          const double sr = tr[1] + tr[2], si = ti[1] + ti[2];
+          const double mr = tr[0] + c3 * sr, mi = ti[0] + c3 * si;
+          // d = s3 * (-i) (t1 - t2)
+          const double dr = s3 * (ti[1] - ti[2]), di = -s3 * (tr[1] - tr[2]);
+          xr[0][c] = tr[0] + sr;
+          xi[0][c] = ti[0] + si;
+          xr[1][c] = mr + dr;
+          xi[1][c] = mi + di;
+          xr[2][c] = mr - dr;
+          xi[2][c] = mi - di;
+        } else if constexpr (P == 4) {
+          const double e0r = tr[0] + tr[2], e0i = ti[0] + ti[2];
+          const double e1r = tr[0] - tr[2], e1i = ti[0] - ti[2];
+          const double o0r = tr[1] + tr[3], o0i = ti[1] + ti[3];
+          // o1 = (-i) (t1 - t3)
+          const double o1r = ti[1] - ti[3], o1i = tr[3] - tr[1];
+          xr[0][c] = e0r + o0r;
+          xi[0][c] = e0i + o0i;
+          xr[1][c] = e1r + o1r;
+          xi[1][c] = e1i + o1i;
+          xr[2][c] = e0r - o0r;
+          xi[2][c] = e0i - o0i;
+          xr[3][c] = e1r - o1r;
+          xi[3][c] = e1i - o1i;
+        } else {
+          const double a1r = tr[1] + tr[4], a1i = ti[1] + ti[4];
+          const double b1r = tr[1] - tr[4], b1i = ti[1] - ti[4];
+          const double a2r = tr[2] + tr[3], a2i = ti[2] + ti[3];
+          const double b2r = tr[2] - tr[3], b2i = ti[2] - ti[3];
+          const double m1r = tr[0] + c51 * a1r + c52 * a2r;
+          const double m1i = ti[0] + c51 * a1i + c52 * a2i;
+          const double m2r = tr[0] + c52 * a1r + c51 * a2r;
+          const double m2i = ti[0] + c52 * a1i + c51 * a2i;
+          // d1 = (-i) (s51 b1 + s52 b2), d2 = (-i) (s52 b1 - s51 b2)
+          const double d1r = s51 * b1i + s52 * b2i;
+          const double d1i = -(s51 * b1r + s52 * b2r);
+          const double d2r = s52 * b1i - s51 * b2i;
+          const double d2i = -(s52 * b1r - s51 * b2r);
+          xr[0][c] = tr[0] + a1r + a2r;
+          xi[0][c] = ti[0] + a1i + a2i;
+          xr[1][c] = m1r + d1r;
+          xi[1][c] = m1i + d1i;
+          xr[2][c] = m2r + d2r;
+          xi[2][c] = m2i + d2i;
+          xr[3][c] = m2r - d2r;
+          xi[3][c] = m2i - d2i;
+          xr[4][c] = m1r - d1r;
+          xi[4][c] = m1i - d1i;
+        }
+      }
+    }
+  }
+}
+} // namespace
+
+bool FftPlan::isSupportedSize(int n) {
+  return n >= 4 && (n % 2) == 0 && !factorize(n / 2).isEmpty();
+}
+
+int FftPlan::goodSize(int n) {
+  n = std::max(4, n + (n & 1));
+  while (!isSupportedSize(n))
+    n += 2;
+  return n;
+}
+
+int FftPlan::sizeForWindow(double sampleRate, double seconds,
+                           double resolutionHz) {
+  if (sampleRate <= 0.0)
+    return 0;
+  double samples = seconds * sampleRate;
+  if (resolutionHz > 0.0)
+    samples = std::max(samples, sampleRate / resolutionHz);
+  return goodSize(qRound(samples));
+}
+
+FftPlan::FftPlan(int n) : m_n(n), m_half(n / 2) {
+  if (!isSupportedSize(n)) {
+    m_n = m_half = 0;
+    return;
+  }
+
+  const int M = m_half;
+  m_radix = factorize(M);
+
+  // Digit-Reversal für die komplexe Länge M
+  QVector<int> idx(M);
+  for (int i = 0; i < M; ++i)
+    idx[i] = i;
+  m_perm.reserve(M);
+  digitReverse(idx, m_radix, m_radix.size(), m_perm);
+
+  // Twiddles direkt aus cos/sin (kein rekursives Aufmultiplizieren)
+  m_twiddle.resize(M);
+  for (int j = 0; j < M; ++j) {
+    double ang = -2.0 * M_PI * double(j) / double(M);
+    m_twiddle[j] = Complex(std::cos(ang), std::sin(ang));
+  }
+
+  m_realTw.resize(M / 2 + 1);
+  for (int k = 0; k <= M / 2; ++k) {
+    double ang = -2.0 * M_PI * double(k) / double(m_n);
+    m_realTw[k] = Complex(std::cos(ang), std::sin(ang));
+  }
+}
+
+std::shared_ptr<const FftPlan> FftPlan::forSize(int n) {
+  static QMutex mutex;
+  static QHash<int, std::shared_ptr<const FftPlan>> cache;
+
+  QMutexLocker lock(&mutex);
+  auto plan = cache.value(n);
+  if (!plan) {
+    plan = std::make_shared<const FftPlan>(n);
+    cache.insert(n, plan);
+  }
+  return plan;
+}
+
+std::shared_ptr<const QVector<double>> FftPlan::hannWindow(int n) {
+  static QMutex mutex;
+  static QHash<int, std::shared_ptr<const QVector<double>>> cache;
+
+  QMutexLocker lock(&mutex);
+  auto win = cache.value(n);
+  if (!win) {
+    auto w = std::make_shared<QVector<double>>(std::max(0, n));
+    for (int i = 0; i < n; ++i)
+      (*w)[i] = (n > 1) ? 0.5 * (1.0 - std::cos(2.0 * M_PI * i / (n - 1))) : 1.0;
+    win = w;
+    cache.insert(n, win);
+  }
+  return win;
+}
+
+void FftPlan::complexFft(Complex *a) const {
+  // Iterative Mixed-Radix-DIT, Eingang liegt bereits in Digit-Reversal-Ordnung
+  const int M = m_half;
+  const Complex *tw = m_twiddle.constData();
+
+  int Lp = 1;
+  for (int p : m_radix) {
+    switch (p) {
+    case 2:
+      radixStage<2>(a, M, Lp, tw);
+      break;
+    case 3:
+      radixStage<3>(a, M, Lp, tw);
+      break;
+    case 4:
+      radixStage<4>(a, M, Lp, tw);
+      break;
+    case 5:
+      radixStage<5>(a, M, Lp, tw);
+      break;
+    }
+    Lp *= p;
+  }
+}
+
+void FftPlan::forwardReal(const double *in, Complex *out) const {
+  const int M = m_half;
+  if (M == 0)
+    return;
+
+  // Packen: z[n] = x[2n] + i x[2n+1], gleich in Digit-Reversal-Ordnung
+  const int *perm = m_perm.constData();
+  for (int i = 0; i < M; ++i)
+    out[i] = Complex(in[2 * perm[i]], in[2 * perm[i] + 1]);
+
+  complexFft(out);
+
+  // Entflechtung: X[k] = E[k] + W^k O[k], X[M-k] = conj(E[k] - W^k O[k])
+  const Complex z0 = out[0];
+  out[0] = Complex(z0.real() + z0.imag(), 0.0);
+  out[M] = Complex(z0.real() - z0.imag(), 0.0);
+
+  const Complex *w = m_realTw.constData();
+  for (int k = 1; k <= M / 2; ++k) {
+    const Complex zk = out[k];
+    const Complex zmk = std::conj(out[M - k]);
+    const Complex e = 0.5 * (zk + zmk);
+    const Complex o = Complex(0.0, -0.5) * (zk - zmk);
+    const Complex wo = w[k] * o;
+    out[k] = e + wo;
+    if (k != M - k)
+      out[M - k] = std::conj(e - wo);
+  }
+}
+
+void FftPlan::forwardComplex(const Complex *in, Complex *out) const {
+  const int M = m_half;
+  const int *perm = m_perm.constData();
+  for (int i = 0; i < M; ++i)
+    out[i] = in[perm[i]];
+  complexFft(out);
+}
+
+void FftPlan::complexFftBatch(double *re, double *im, int channels) const {
+  const int M = m_half;
+  const Complex *tw = m_twiddle.constData();
+
+  int Lp = 1;
+  for (int p : m_radix) {
+    switch (p) {
+    case 2:
+      radixStageBatch<2>(re, im, M, channels, Lp, tw);
+      break;
+    case 3:
+      radixStageBatch<3>(re, im, M, channels, Lp, tw);
+      break;
+    case 4:
+      radixStageBatch<4>(re, im, M, channels, Lp, tw);
+      break;
+    case 5:
+      radixStageBatch<5>(re, im, M, channels, Lp, tw);
+      break;
+    }
+    Lp *= p;
+  }
+}
+
+void FftPlan::transformBatch(const double *in, int channels,
+                             FftBatchWorkspace &ws) const {
+  const int M = m_half;
+  const int C = channels;
+  ws.ensure(m_n, C);
+  double *re = ws.re.data();
+  double *im = ws.im.data();
+
+  // Packen wie forwardReal, für alle Kanäle: z_c[n] = x_c[2n] + i x_c[2n+1]
+  const int *perm = m_perm.constData();
+  for (int i = 0; i < M; ++i) {
+    const double *even = in + (2 * perm[i]) * C;
+    const double *odd = even + C;
+    double *r = re + i * C;
+    double *m = im + i * C;
+    for (int c = 0; c < C; ++c) {
+      r[c] = even[c];
+      m[c] = odd[c];
+    }
+  }
+
+  complexFftBatch(re, im, C);
+}
+
+void FftPlan::forwardPowerBatch(const double *in, int channels,
+                                FftBatchWorkspace &ws, double *power) const {
+  const int M = m_half;
+  const int C = channels;
+  if (M == 0 || C <= 0)
+    return;
+
+  transformBatch(in, C, ws);
+  const double *re = ws.re.data();
+  const double *im = ws.im.data();
+
+  // Entflechtung direkt in |X|^2, Ausgabe zeilenweise je Kanal
+  const int K = M + 1;
+  for (int c = 0; c < C; ++c) {
+    const double z0r = re[c], z0i = im[c];
+    power[c * K] = (z0r + z0i) * (z0r + z0i);
+    power[c * K + M] = (z0r - z0i) * (z0r - z0i);
+  }
+
+  const Complex *w = m_realTw.constData();
+  for (int k = 1; k <= M / 2; ++k) {
+    const double wr = w[k].real(), wi = w[k].imag();
+    const double *zkr = re + k * C, *zki = im + k * C;
+    const double *zmr = re + (M - k) * C, *zmi = im + (M - k) * C;
+    for (int c = 0; c < C; ++c) {
+      // e = (z_k + conj z_{M-k}) / 2, o = -i (z_k - conj z_{M-k}) / 2
+      const double er = 0.5 * (zkr[c] + zmr[c]);
+      const double ei = 0.5 * (zki[c] - zmi[c]);
+      const double or_ = 0.5 * (zki[c] + zmi[c]);
+      const double oi = -0.5 * (zkr[c] - zmr[c]);
+      const double wor = wr * or_ - wi * oi;
+      const double woi = wr * oi + wi * or_;
+      double *pc = power + c * K;
+      pc[k] = (er + wor) * (er + wor) + (ei + woi) * (ei + woi);
+      pc[M - k] = (er - wor) * (er - wor) + (ei - woi) * (ei - woi);
+    }
+  }
+}
+
+void FftPlan::forwardBatch(const double *in, int channels,
+                           FftBatchWorkspace &ws, double *outRe,
+                           double *outIm) const {
+  const int M = m_half;
+  const int C = channels;
+  if (M == 0 || C <= 0)
+    return;
+
+  transformBatch(in, C, ws);
+  const double *re = ws.re.data();
+  const double *im = ws.im.data();
+
+  // Entflechtung wie forwardPowerBatch, aber komplex:
+  // X[k] = e + w o, X[M-k] = conj(e - w o)
+  const int K = M + 1;
+  for (int c = 0; c < C; ++c) {
+    outRe[c * K] = re[c] + im[c];
+    outIm[c * K] = 0.0;
+    outRe[c * K + M] = re[c] - im[c];
+    outIm[c * K + M] = 0.0;
+  }
+
+  const Complex *w = m_realTw.constData();
+  for (int k = 1; k <= M / 2; ++k) {
+    const double wr = w[k].real(), wi = w[k].imag();
+    const double *zkr = re + k * C, *zki = im + k * C;
+    const double *zmr = re + (M - k) * C, *zmi = im + (M - k) * C;
+    for (int c = 0; c < C; ++c) {
+      const double er = 0.5 * (zkr[c] + zmr[c]);
+      const double ei = 0.5 * (zki[c] - zmi[c]);
+      const double or_ = 0.5 * (zki[c] + zmi[c]);
+      const double oi = -0.5 * (zkr[c] - zmr[c]);
+      const double wor = wr * or_ - wi * oi;
+      const double woi = wr * oi + wi * or_;
+      outRe[c * K + k] = er + wor;
+      outIm[c * K + k] = ei + woi;
+      outRe[c * K + M - k] = er - wor;
+      outIm[c * K + M - k] = woi - ei;
+    }
+  }
+}
@@ -0,0 +1,138 @@
+#ifndef FFTPLAN_H
+#define FFTPLAN_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <complex>
+#include <memory>
+
+/**
+ * 64-Byte-ausgerichteter Puffer fester Länge (cache-line-/SIMD-tauglich).
+ * Wird nur bei Größenänderung neu angelegt.
+ */
+template <typename T> class AlignedBuffer {
+public:
+  static constexpr size_t Alignment = 64;
+
+  AlignedBuffer() = default;
+  explicit AlignedBuffer(int n) { resize(n); }
+  ~AlignedBuffer() { qFreeAligned(m_data); }
+  AlignedBuffer(const AlignedBuffer &) = delete;
+  AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+  void resize(int n) {
+    if (n == m_size)
+      return;
+    qFreeAligned(m_data);
+    m_data = (n > 0) ? static_cast<T *>(qMallocAligned(sizeof(T) * size_t(n),
+                                                       Alignment))
+                     : nullptr;
+    m_size = n;
+    for (int i = 0; i < m_size; ++i)
+      new (m_data + i) T();
+  }
+
+  int size() const { return m_size; }
+  T *data() { return m_data; }
+  const T *data() const { return m_data; }
+  T &operator[](int i) { return m_data[i]; }
+  const T &operator[](int i) const { return m_data[i]; }
+
+private:
+  T *m_data = nullptr;
+  int m_size = 0;
+};
+
+struct FftBatchWorkspace;
+
+/**
+ * Vorberechneter FFT-Plan für reelle Eingangsdaten der Länge N.
+ *
+ * - N gerade, N/2 = 2^a 3^b 5^c (Mixed-Radix 2/3/4/5), z.B. 750 oder 6000;
+ *   damit passt die FFT-Länge zur Fensterdauer statt zur nächsten 2er-Potenz
+ * - Twiddle-Faktoren und Digit-Reversal-Tabelle werden einmal pro Größe
+ *   berechnet (kein cos/sin und kein akkumuliertes w *= wlen zur Laufzeit)
+ * - Reelle Eingabe über den N/2-Trick: x[2n] + i x[2n+1] als komplexe FFT
+ *   der Länge N/2, danach Entflechtung in die N/2+1 Bins
+ * - Pläne sind unveränderlich und damit über Threads teilbar; Puffer
+ *   liefert der Aufrufer (FftWorkspace)
+ */
+class FftPlan {
+public:
+  using Complex = std::complex<double>;
+
+  explicit FftPlan(int n);
+
+  /// Gecachter Plan für Länge n (threadsicher)
+  static std::shared_ptr<const FftPlan> forSize(int n);
+
+  /// Gecachtes Hann-Fenster der Länge n (threadsicher)
+  static std::shared_ptr<const QVector<double>> hannWindow(int n);
+
+  static bool isSupportedSize(int n);
+  /// Kleinste unterstützte Länge >= n
+  static int goodSize(int n);
+  /// Länge für ein Analysefenster (Sekunden) bei fs, mindestens so lang,
+  /// dass die Auflösung fs/N <= resolutionHz ist (0 = keine Vorgabe)
+  static int sizeForWindow(double sampleRate, double seconds,
+                           double resolutionHz = 0.0);
+
+  int size() const { return m_n; }
+  int bins() const { return m_n / 2 + 1; }
+
+  /// in: N reelle Samples, out: N/2+1 komplexe Bins (out[k] = sum x[n] e^-2pi i kn/N)
+  void forwardReal(const double *in, Complex *out) const;
+
+  /// Komplexe FFT der Länge size()/2 (in und out dürfen nicht überlappen)
+  void forwardComplex(const Complex *in, Complex *out) const;
+
+  /// Alle Kanäle in einem Aufruf: in[n * channels + c] (interleavt, bereits
+  /// gefenstert), power[c * bins() + k] = |X_c[k]|^2. Die Butterflies laufen
+  /// in der innersten Schleife über die Kanäle (SoA, vektorisierbar).
+  void forwardPowerBatch(const double *in, int channels, FftBatchWorkspace &ws,
+                         double *power) const;
+
+  /// Wie forwardPowerBatch, aber komplexe Bins getrennt nach Real-/
+  /// Imaginärteil: outRe/outIm[c * bins() + k] = X_c[k]
+  void forwardBatch(const double *in, int channels, FftBatchWorkspace &ws,
+                    double *outRe, double *outIm) const;
+
+private:
+  void complexFft(Complex *a) const;
+  /// Packen + Batch-FFT der Länge N/2 nach ws.re/ws.im
+  void transformBatch(const double *in, int channels,
+                      FftBatchWorkspace &ws) const;
+  void complexFftBatch(double *re, double *im, int channels) const;
+
+  int m_n = 0;                // reelle Länge
+  int m_half = 0;             // komplexe Länge M = N/2
+  QVector<int> m_radix;       // Radix je Stufe (erste Stufe zuerst)
+  QVector<int> m_perm;        // Digit-Reversal-Permutation (Länge M)
+  QVector<Complex> m_twiddle; // e^{-2pi i j/M}, j < M
+  QVector<Complex> m_realTw;  // e^{-2pi i k/N}, k <= M/2 (Entflechtung)
+};
+
+/// Vorallozierte, ausgerichtete Arbeitspuffer für FftPlan
+struct FftWorkspace {
+  AlignedBuffer<double> input;           // N (gefenstertes Signal)
+  AlignedBuffer<FftPlan::Complex> bins;  // N/2 + 1
+
+  void ensure(int n) {
+    input.resize(n);
+    bins.resize(n / 2 + 1);
+  }
+};
+
+/// Arbeitspuffer für FftPlan::forwardPowerBatch (Real-/Imaginärteil getrennt,
+/// [i * channels + c])
+struct FftBatchWorkspace {
+  AlignedBuffer<double> re;
+  AlignedBuffer<double> im;
+
+  void ensure(int n, int channels) {
+    re.resize(n / 2 * channels);
+    im.resize(n / 2 * channels);
+  }
+};
+
+#endif // FFTPLAN_H
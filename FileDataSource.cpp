@@ -144,7 +144,7 @@ void FileDataSource::generateFromFile() {
   qint64 expectedSamples = elapsedMs * m_sampleRate / 1000;
 
   while (m_samplesEmitted < expectedSamples) {
-    emit newEEGData(m_samples[m_index]);
+    publishSample(m_samples[m_index]);
 
     m_index++;
     m_samplesEmitted++;
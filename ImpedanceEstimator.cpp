@@ -0,0 +1,133 @@
+#include "ImpedanceEstimator.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// ADS1299 AC-Lead-Off: 6 nA Rechteckstrom. Die Grundschwingung eines
+// Rechtecks mit Amplitude I hat die Spitzenamplitude 4/pi * I.
+constexpr double kLeadOffCurrentA = 6.0e-9;
+constexpr double kFundamentalCurrentA = 4.0 / M_PI * kLeadOffCurrentA;
+
+// Serienwiderstand im Eingangspfad (wie OpenBCI Cyton)
+constexpr double kSeriesResistorOhm = 2200.0;
+
+// Leichte Dämpfung der Resonator-Pole (r < 1), damit sich Rundungsfehler
+// im Dauerbetrieb nicht aufsummieren.
+constexpr double kDamping = 1.0 - 1e-9;
+} // namespace
+
+ImpedanceEstimator::ImpedanceEstimator(int numChannels, double sampleRate,
+                                       double excitationHz, double windowSec)
+    : m_numChannels(numChannels), m_sampleRate(sampleRate),
+      m_excitationHz(excitationHz), m_windowSec(windowSec) {
+  design();
+}
+
+void ImpedanceEstimator::updateSampleRate(double fs) {
+  if (fs <= 0.0 || fs == m_sampleRate)
+    return;
+  m_sampleRate = fs;
+  design();
+}
+
+void ImpedanceEstimator::design() {
+  m_windowLength = 0;
+  m_s1.clear();
+  m_s2.clear();
+  m_delay.clear();
+  m_pos = 0;
+  m_filled = 0;
+
+  if (m_numChannels <= 0 || m_sampleRate <= 0.0 || m_excitationHz <= 0.0 ||
+      m_excitationHz >= m_sampleRate / 2.0)
+    return;
+
+  // Ganzzahlige Periodenzahl im Fenster, Fensterlänge so wählen, dass die
+  // Anregung genau auf Bin k liegt (kein Leckeffekt von DC/Drift).
+  m_bin = std::max(1, qRound(m_excitationHz * m_windowSec));
+  m_windowLength = std::max(2 * m_bin + 1,
+                            qRound(m_bin * m_sampleRate / m_excitationHz));
+
+  double w = 2.0 * M_PI * double(m_bin) / double(m_windowLength);
+  m_cosW = std::cos(w);
+  m_sinW = std::sin(w);
+  m_coeff = 2.0 * kDamping * m_cosW;
+  m_rN = std::pow(kDamping, m_windowLength);
+
+  m_s1.resize(m_numChannels);
+  m_s2.resize(m_numChannels);
+  m_delay.resize(m_numChannels * m_windowLength);
+  reset();
+}
+
+void ImpedanceEstimator::reset() {
+  m_s1.fill(0.0);
+  m_s2.fill(0.0);
+  m_delay.fill(0.0);
+  m_pos = 0;
+  m_filled = 0;
+}
+
+void ImpedanceEstimator::processFrame(const QVector<double> &rawMicrovolts) {
+  if (m_windowLength <= 0)
+    return;
+
+  const int n = std::min(m_numChannels, int(rawMicrovolts.size()));
+  const double r2 = kDamping * kDamping;
+
+  for (int ch = 0; ch < n; ++ch) {
+    double &old = m_delay[ch * m_windowLength + m_pos];
+    const double x = rawMicrovolts[ch];
+
+    // Kammfilter (x[n] - r^N x[n-N]) + Goertzel-Resonator
+    const double s0 = (x - m_rN * old) + m_coeff * m_s1[ch] - r2 * m_s2[ch];
+    m_s2[ch] = m_s1[ch];
+    m_s1[ch] = s0;
+    old = x;
+  }
+
+  if (++m_pos >= m_windowLength)
+    m_pos = 0;
+  if (m_filled < m_windowLength)
+    ++m_filled;
+}
+
+double ImpedanceEstimator::amplitude(int channelIndex) const {
+  if (channelIndex < 0 || channelIndex >= m_numChannels || m_windowLength <= 0)
+    return 0.0;
+
+  // |X_k| = |s[n] - r e^{-jw} s[n-1]|
+  const double s1 = m_s1[channelIndex];
+  const double s2 = kDamping * m_s2[channelIndex];
+  const double re = s1 - s2 * m_cosW;
+  const double im = s2 * m_sinW;
+  const double mag = std::sqrt(re * re + im * im);
+
+  // Sinus mit Amplitude A liefert |X_k| = A * N / 2
+  return 2.0 * mag / double(m_windowLength);
+}
+
+double ImpedanceEstimator::impedanceKOhm(int channelIndex) const {
+  if (!isReady())
+    return std::numeric_limits<double>::quiet_NaN();
+
+  const double volts = amplitude(channelIndex) * 1e-6;
+  const double ohm = volts / kFundamentalCurrentA - kSeriesResistorOhm;
+  return std::max(0.0, ohm) / 1000.0;
+}
+
+QVector<double> ImpedanceEstimator::impedancesKOhm() const {
+  QVector<double> z(m_numChannels);
+  for (int ch = 0; ch < m_numChannels; ++ch)
+    z[ch] = impedanceKOhm(ch);
+  return z;
+}
+
+double ImpedanceEstimator::binFrequency() const {
+  if (m_windowLength <= 0)
+    return 0.0;
+  return double(m_bin) * m_sampleRate / double(m_windowLength);
+}
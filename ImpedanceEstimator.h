@@ -0,0 +1,70 @@
+#ifndef IMPEDANCEESTIMATOR_H
+#define IMPEDANCEESTIMATOR_H
+
+#include <QVector>
+
+/**
+ * Kontinuierliche Elektrodenimpedanz aus dem Rohdatenstrom.
+ *
+ * Während der AC-Lead-Off-Anregung des ADS1299 (Rechteckstrom, 31.25 Hz)
+ * wird pro Kanal die Amplitude bei der Anregungsfrequenz mit einem
+ * gleitenden Goertzel-Filter gemessen (O(1) pro Sample und Kanal).
+ * Eingang sind die ungefilterten µV-Werte (vor Notch/Bandlimit).
+ */
+class ImpedanceEstimator
+{
+public:
+    ImpedanceEstimator(int numChannels,
+                       double sampleRate,
+                       double excitationHz = 31.25,
+                       double windowSec    = 2.0);
+
+    int    channelCount()  const { return m_numChannels; }
+    double sampleRate()    const { return m_sampleRate; }
+
+    /// Ein Frame (ein Sample pro Kanal, Rohwerte in µV) verarbeiten
+    void processFrame(const QVector<double> &rawMicrovolts);
+
+    /// Delay-Lines und Resonatoren zurücksetzen
+    void reset();
+
+    /// Sample-Rate ändern (Fensterlänge wird neu bestimmt)
+    void updateSampleRate(double fs);
+
+    /// Peak-Amplitude (µV) der Anregungsfrequenz
+    double amplitude(int channelIndex) const;
+
+    /// Impedanz in kOhm (NaN solange das Fenster noch nicht gefüllt ist)
+    double impedanceKOhm(int channelIndex) const;
+    QVector<double> impedancesKOhm() const;
+
+    /// true, sobald ein komplettes Fenster eingelaufen ist
+    bool isReady() const { return m_filled >= m_windowLength; }
+
+    /// Effektive Frequenz des Goertzel-Bins (ganzzahliger Bin im Fenster)
+    double binFrequency() const;
+
+private:
+    void design();
+
+    int    m_numChannels  = 0;
+    double m_sampleRate   = 250.0;
+    double m_excitationHz = 31.25;
+    double m_windowSec    = 2.0;
+
+    int    m_windowLength = 0;   // N
+    int    m_bin          = 0;   // k
+    double m_coeff        = 0.0; // 2 r cos(w)
+    double m_cosW         = 1.0;
+    double m_sinW         = 0.0;
+    double m_rN           = 1.0; // r^N (Kompensation der Dämpfung im Kamm)
+
+    // Pro Kanal: Resonatorzustand + Delay-Line (N Samples, Ringpuffer)
+    QVector<double> m_s1;
+    QVector<double> m_s2;
+    QVector<double> m_delay;     // [channel * N + pos]
+    int             m_pos    = 0;
+    int             m_filled = 0;
+};
+
+#endif // IMPEDANCEESTIMATOR_H
@@ -0,0 +1,75 @@
+#include "MinMaxEnvelope.h"
+
+#include <algorithm>
+#include <cmath>
+
+MinMaxEnvelope::MinMaxEnvelope(int channels)
+    : m_channels(std::max(1, channels)) {}
+
+void MinMaxEnvelope::setChannels(int channels) {
+  channels = std::max(1, channels);
+  if (channels == m_channels)
+    return;
+  m_channels = channels;
+  configure(m_samplesPerColumn, m_columns);
+}
+
+void MinMaxEnvelope::configure(double samplesPerColumn, int columns) {
+  m_samplesPerColumn = std::max(1.0, samplesPerColumn);
+  m_columns = std::max(0, columns);
+  // Reserve: angefangene Spalte + Rundung am linken Rand
+  m_capacity = m_columns > 0 ? m_columns + 4 : 0;
+  m_low.fill(0.0, m_capacity * m_channels);
+  m_high.fill(0.0, m_capacity * m_channels);
+  reset();
+}
+
+bool MinMaxEnvelope::matches(double samplesPerColumn, int columns) const {
+  return columns == m_columns &&
+         std::abs(std::max(1.0, samplesPerColumn) - m_samplesPerColumn) <=
+             1e-6 * m_samplesPerColumn;
+}
+
+void MinMaxEnvelope::reset() {
+  m_firstColumn = 0;
+  m_lastColumn = -1;
+  m_nextIndex = -1;
+}
+
+qint64 MinMaxEnvelope::columnOf(qint64 sampleIndex) const {
+  return qint64(std::floor(double(sampleIndex) / m_samplesPerColumn));
+}
+
+void MinMaxEnvelope::append(const double *interleaved, int frames, int stride,
+                            qint64 firstIndex) {
+  if (m_capacity == 0 || frames <= 0)
+    return;
+  if (firstIndex != m_nextIndex)
+    reset();
+
+  const int C = std::min(m_channels, stride);
+  for (int f = 0; f < frames; ++f) {
+    const double *x = interleaved + f * stride;
+    const qint64 col = columnOf(firstIndex + f);
+    double *lo = m_low.data() + slot(col) * m_channels;
+    double *hi = m_high.data() + slot(col) * m_channels;
+
+    if (col > m_lastColumn) {
+      // Neue Spalte beginnt mit diesem Sample
+      for (int c = 0; c < C; ++c)
+        lo[c] = hi[c] = x[c];
+      std::fill(lo + C, lo + m_channels, 0.0);
+      std::fill(hi + C, hi + m_channels, 0.0);
+      if (isEmpty())
+        m_firstColumn = col;
+      m_lastColumn = col;
+      m_firstColumn = std::max(m_firstColumn, col - m_capacity + 1);
+    } else {
+      for (int c = 0; c < C; ++c) {
+        lo[c] = std::min(lo[c], x[c]);
+        hi[c] = std::max(hi[c], x[c]);
+      }
+    }
+  }
+  m_nextIndex = firstIndex + frames;
+}
@@ -0,0 +1,76 @@
+#ifndef MINMAXENVELOPE_H
+#define MINMAXENVELOPE_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * Min/Max-Hüllkurve je Pixelspalte für Live-Spuren (ein oder mehrere
+ * Kanäle).
+ *
+ * Spalte j umfasst die Samples mit floor(index / samplesPerColumn) == j,
+ * ausgerichtet am laufenden Sample-Index statt am Bildrand: beim
+ * Weiterscrollen bleiben fertige Spalten unverändert, neue Samples
+ * aktualisieren nur die jüngste(n) Spalte(n). Zeichnen kostet damit
+ * O(Spalten) statt O(Samples), unabhängig von der Abtastrate, und jede
+ * Spitze bleibt als Min bzw. Max ihrer Spalte erhalten.
+ *
+ * Neu aufgebaut (configure + append aus dem Sample-Puffer) wird nur bei
+ * Zoom oder Größenänderung.
+ */
+class MinMaxEnvelope
+{
+public:
+    explicit MinMaxEnvelope(int channels = 1);
+
+    /// Spaltenbreite in Samples (>= 1, auch gebrochen) und Anzahl
+    /// vorgehaltener Spalten; leert die Hüllkurve
+    void configure(double samplesPerColumn, int columns);
+    /// Gleiche Spaltenbreite (bis auf Rundung der Achsenbereiche) und Anzahl
+    bool matches(double samplesPerColumn, int columns) const;
+    bool isConfigured() const { return m_columns > 0; }
+
+    void setChannels(int channels);
+    int channels() const { return m_channels; }
+
+    void reset();
+
+    /// frames Frames (Kanal c bei interleaved[f * stride + c]) ab dem
+    /// laufenden Index firstIndex; eine Lücke beginnt neu
+    void append(const double *interleaved, int frames, int stride,
+                qint64 firstIndex);
+
+    qint64 columnOf(qint64 sampleIndex) const;
+    /// Erster Sample-Index einer Spalte (gebrochen)
+    double columnStart(qint64 column) const { return column * m_samplesPerColumn; }
+
+    /// Gültige Spalten [firstColumn, lastColumn]; leer, wenn last < first
+    qint64 firstColumn() const { return m_firstColumn; }
+    qint64 lastColumn() const { return m_lastColumn; }
+    bool isEmpty() const { return m_lastColumn < m_firstColumn; }
+
+    double low(qint64 column, int channel) const
+    {
+        return m_low[slot(column) * m_channels + channel];
+    }
+    double high(qint64 column, int channel) const
+    {
+        return m_high[slot(column) * m_channels + channel];
+    }
+
+private:
+    int slot(qint64 column) const { return int(column % m_capacity); }
+
+    int    m_channels = 1;
+    double m_samplesPerColumn = 1.0;
+    int    m_columns  = 0;
+    int    m_capacity = 0;       // Ring über die Spalten (columns + Reserve)
+
+    QVector<double> m_low;       // [slot * channels + c]
+    QVector<double> m_high;
+    qint64 m_firstColumn = 0;
+    qint64 m_lastColumn  = -1;
+    qint64 m_nextIndex   = -1;   // erwarteter nächster Sample-Index
+};
+
+#endif // MINMAXENVELOPE_H
@@ -0,0 +1,271 @@
+#include "ProcessingPipeline.h"
+#include "DataProcessingQt.h"
+
+#include <QElapsedTimer>
+#include <algorithm>
+#include <utility>
+
+namespace {
+// Glättung für die mittlere Laufzeit pro Block
+constexpr double kAvgAlpha = 0.05;
+} // namespace
+
+ProcessingPipeline::~ProcessingPipeline() { qDeleteAll(m_stages); }
+
+bool ProcessingPipeline::addStage(PipelineStage *stage) {
+  if (!stage || m_stages.contains(stage->name()))
+    return false;
+  m_stages.insert(stage->name(), stage);
+  m_names.append(stage->name());
+  rebuildOrder();
+  return true;
+}
+
+void ProcessingPipeline::removeStage(const QString &name) {
+  PipelineStage *s = m_stages.take(name);
+  if (!s)
+    return;
+  delete s;
+  m_names.removeAll(name);
+  m_edges.remove(name);
+  for (auto it = m_edges.begin(); it != m_edges.end(); ++it)
+    it->removeAll(name);
+  rebuildOrder();
+}
+
+PipelineStage *ProcessingPipeline::stage(const QString &name) const {
+  return m_stages.value(name, nullptr);
+}
+
+bool ProcessingPipeline::connectStages(const QString &from, const QString &to) {
+  if (!m_stages.contains(from) || !m_stages.contains(to) || from == to)
+    return false;
+  if (m_edges.value(from).contains(to))
+    return true;
+
+  m_edges[from].append(to);
+  if (!rebuildOrder()) {
+    // Zyklus -> Kante wieder entfernen
+    m_edges[from].removeAll(to);
+    rebuildOrder();
+    return false;
+  }
+  return true;
+}
+
+void ProcessingPipeline::disconnectStages(const QString &from,
+                                          const QString &to) {
+  if (!m_edges.contains(from))
+    return;
+  m_edges[from].removeAll(to);
+  rebuildOrder();
+}
+
+QStringList ProcessingPipeline::successors(const QString &name) const {
+  return m_edges.value(name);
+}
+
+bool ProcessingPipeline::rebuildOrder() {
+  // Kahn-Algorithmus, stabil bzgl. Einfüge-Reihenfolge
+  QHash<QString, int> inDegree;
+  for (const QString &n : m_names)
+    inDegree[n] = 0;
+  for (auto it = m_edges.cbegin(); it != m_edges.cend(); ++it)
+    for (const QString &to : it.value())
+      ++inDegree[to];
+
+  m_roots.clear();
+  QStringList ready;
+  for (const QString &n : m_names) {
+    if (inDegree.value(n) == 0) {
+      ready.append(n);
+      m_roots.append(n);
+    }
+  }
+
+  QStringList order;
+  while (!ready.isEmpty()) {
+    QString n = ready.takeFirst();
+    order.append(n);
+    for (const QString &to : m_edges.value(n)) {
+      if (--inDegree[to] == 0)
+        ready.append(to);
+    }
+  }
+
+  if (order.size() != m_names.size())
+    return false;
+  m_order = order;
+  return true;
+}
+
+void ProcessingPipeline::push(const FrameBlock &block) {
+  for (const QString &n : m_roots)
+    m_stages[n]->m_input.enqueue(block);
+}
+
+void ProcessingPipeline::run() {
+  QElapsedTimer timer;
+
+  for (const QString &n : m_order) {
+    PipelineStage *s = m_stages[n];
+    PipelineStage::Stats &st = s->m_stats;
+
+    const QStringList next = m_edges.value(n);
+
+    while (!s->m_input.isEmpty()) {
+      FrameBlock block = s->m_input.dequeue();
+
+      bool forward = true;
+      if (s->m_enabled) {
+        timer.start();
+        forward = s->process(block);
+        double us = double(timer.nsecsElapsed()) / 1000.0;
+
+        st.lastUs = us;
+        st.maxUs = std::max(st.maxUs, us);
+        st.avgUs = (st.blocks == 0) ? us : st.avgUs + kAvgAlpha * (us - st.avgUs);
+        ++st.blocks;
+        st.frames += block.frameCount();
+      }
+
+      if (!forward)
+        continue;
+      for (const QString &to : next)
+        m_stages[to]->m_input.enqueue(block);
+    }
+  }
+}
+
+void ProcessingPipeline::reset() {
+  for (PipelineStage *s : std::as_const(m_stages)) {
+    s->m_input.clear();
+    s->reset();
+  }
+}
+
+void ProcessingPipeline::resetStats() {
+  for (PipelineStage *s : std::as_const(m_stages))
+    s->resetStats();
+}
+
+double ProcessingPipeline::totalAvgUs() const {
+  double sum = 0.0;
+  for (const PipelineStage *s : m_stages)
+    if (s->isEnabled())
+      sum += s->stats().avgUs;
+  return sum;
+}
+
+QString ProcessingPipeline::statsReport() const {
+  QStringList lines;
+  for (const QString &n : m_order) {
+    const PipelineStage *s = m_stages[n];
+    const PipelineStage::Stats &st = s->stats();
+    lines << QString("%1%2: %3 µs/block (max %4), %5 frames")
+                 .arg(n)
+                 .arg(s->isEnabled() ? "" : " [off]")
+                 .arg(st.avgUs, 0, 'f', 1)
+                 .arg(st.maxUs, 0, 'f', 1)
+                 .arg(st.frames);
+  }
+  return lines.join('\n');
+}
+
+// -----------------------------------------------------------------------------
+// Standard-Stufen
+// -----------------------------------------------------------------------------
+
+bool DspStage::process(FrameBlock &block) {
+  if (!m_processor)
+    return true;
+
+  const int frames = block.frameCount();
+  const int channels = std::min(block.channels, m_processor->channelCount());
+  double *data = block.samples.data();
+  for (int f = 0; f < frames; ++f) {
+    double *frame = data + f * block.channels;
+    for (int ch = 0; ch < channels; ++ch)
+      frame[ch] = m_processor->processSample(ch, frame[ch]);
+  }
+  return true;
+}
+
+void DecimateStage::setFactor(int factor) {
+  factor = std::max(1, factor);
+  if (factor == m_factor)
+    return;
+  m_factor = factor;
+  m_fill = 0;
+}
+
+bool DecimateStage::process(FrameBlock &block) {
+  if (m_factor <= 1)
+    return true;
+
+  const int frames = block.frameCount();
+  const int channels = block.channels;
+  const int group = 2 * m_factor;
+  if (m_lo.size() != channels) {
+    m_lo.resize(channels);
+    m_hi.resize(channels);
+    m_loAt.resize(channels);
+    m_hiAt.resize(channels);
+    m_fill = 0;
+  }
+
+  QVector<double> out;
+  out.reserve((m_fill + frames) / group * 2 * channels);
+  double outTime = 0.0;
+  qint64 outIndex = 0;
+  const double *in = block.samples.constData();
+  for (int f = 0; f < frames; ++f) {
+    const double *frame = in + f * channels;
+    if (m_fill == 0) {
+      m_groupTime = block.startTime + f * block.dt;
+      m_groupIndex = block.firstIndex + f;
+      for (int ch = 0; ch < channels; ++ch) {
+        m_lo[ch] = m_hi[ch] = frame[ch];
+        m_loAt[ch] = m_hiAt[ch] = 0;
+      }
+    } else {
+      for (int ch = 0; ch < channels; ++ch) {
+        const double v = frame[ch];
+        if (v < m_lo[ch]) {
+          m_lo[ch] = v;
+          m_loAt[ch] = m_fill;
+        } else if (v > m_hi[ch]) {
+          m_hi[ch] = v;
+          m_hiAt[ch] = m_fill;
+        }
+      }
+    }
+    if (++m_fill < group)
+      continue;
+
+    // Gruppe voll: zwei Frames im Abstand factor * dt, je Kanal das frühere
+    // Extremum zuerst
+    if (out.isEmpty()) {
+      outTime = m_groupTime;
+      outIndex = m_groupIndex;
+    }
+    const int base = int(out.size());
+    out.resize(base + 2 * channels);
+    for (int ch = 0; ch < channels; ++ch) {
+      const bool lowFirst = m_loAt[ch] <= m_hiAt[ch];
+      out[base + ch] = lowFirst ? m_lo[ch] : m_hi[ch];
+      out[base + channels + ch] = lowFirst ? m_hi[ch] : m_lo[ch];
+    }
+    m_fill = 0;
+  }
+
+  if (out.isEmpty())
+    return false;
+
+  block.startTime = outTime;
+  block.firstIndex = outIndex;
+  block.dt *= m_factor;
+  block.sampleRate /= m_factor;
+  block.samples = out;
+  return true;
+}
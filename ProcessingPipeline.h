@@ -0,0 +1,191 @@
+#ifndef PROCESSINGPIPELINE_H
+#define PROCESSINGPIPELINE_H
+
+#include <QHash>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+class DataProcessingQt;
+
+/**
+ * Block aus mehreren Frames (ein Frame = ein Sample pro Kanal).
+ * Die Samples liegen interleaved: samples[frame * channels + ch].
+ * QVector ist implizit geteilt, Kopien beim Fan-out kosten also nichts,
+ * solange eine Stage den Block nicht verändert.
+ */
+struct FrameBlock {
+  int channels = 0;
+  double sampleRate = 0.0; // effektive Rate der Frames im Block
+  double startTime = 0.0;  // Zeitstempel des ersten Frames (s)
+  double dt = 0.0;         // Abstand zweier Frames (s)
+  qint64 firstIndex = 0;   // laufender Sample-Index des ersten Frames
+  qint64 arrivalNs = 0;    // Eingangszeitpunkt (monotone Uhr, ns)
+  QVector<double> samples;
+
+  int frameCount() const {
+    return channels > 0 ? int(samples.size()) / channels : 0;
+  }
+  double value(int frame, int ch) const {
+    return samples[frame * channels + ch];
+  }
+};
+
+/**
+ * Eine Stufe im Verarbeitungsgraphen. process() darf den Block verändern;
+ * bei Rückgabe false wird nichts an die Nachfolger weitergereicht
+ * (z.B. Dezimierer, der noch sammelt, oder reine Senken).
+ */
+class PipelineStage {
+public:
+  enum class Kind { Source, Dsp, Decimate, Analysis, Display, Recorder };
+
+  struct Stats {
+    qint64 blocks = 0;
+    qint64 frames = 0;
+    double lastUs = 0.0;
+    double avgUs = 0.0; // gleitender Mittelwert pro Block
+    double maxUs = 0.0;
+  };
+
+  PipelineStage(const QString &name, Kind kind) : m_name(name), m_kind(kind) {}
+  virtual ~PipelineStage() = default;
+
+  QString name() const { return m_name; }
+  Kind kind() const { return m_kind; }
+
+  bool isEnabled() const { return m_enabled; }
+  void setEnabled(bool on) { m_enabled = on; }
+
+  const Stats &stats() const { return m_stats; }
+  void resetStats() { m_stats = Stats(); }
+
+  virtual void reset() {}
+  virtual bool process(FrameBlock &block) = 0;
+
+private:
+  friend class ProcessingPipeline;
+
+  QString m_name;
+  Kind m_kind;
+  bool m_enabled = true;
+  Stats m_stats;
+  QQueue<FrameBlock> m_input;
+};
+
+/**
+ * Gerichteter azyklischer Graph aus Stufen. push() legt einen Block in die
+ * Wurzelstufen (ohne Vorgänger), run() arbeitet alle Queues in
+ * topologischer Reihenfolge ab. Stufen und Kanten können zur Laufzeit
+ * hinzugefügt, entfernt und umgehängt werden. run() läuft synchron im
+ * Aufrufer, nach jedem Lauf sind alle Queues leer; eine Queue-Tiefe wird
+ * deshalb nicht gemeldet.
+ */
+class ProcessingPipeline {
+public:
+  ProcessingPipeline() = default;
+  ~ProcessingPipeline();
+  ProcessingPipeline(const ProcessingPipeline &) = delete;
+  ProcessingPipeline &operator=(const ProcessingPipeline &) = delete;
+
+  /// Übernimmt den Besitz; false bei doppeltem Namen
+  bool addStage(PipelineStage *stage);
+  void removeStage(const QString &name);
+  PipelineStage *stage(const QString &name) const;
+  QStringList stageNames() const { return m_order; }
+
+  /// Kante from -> to; false bei unbekannter Stufe oder Zyklus
+  bool connectStages(const QString &from, const QString &to);
+  void disconnectStages(const QString &from, const QString &to);
+  QStringList successors(const QString &name) const;
+
+  void push(const FrameBlock &block);
+  void run();
+
+  /// Alle Stufen + Queues zurücksetzen
+  void reset();
+  void resetStats();
+
+  /// Summe der mittleren Stufenzeiten (µs/Block)
+  double totalAvgUs() const;
+  QString statsReport() const;
+
+private:
+  bool rebuildOrder();
+
+  QHash<QString, PipelineStage *> m_stages;
+  QHash<QString, QStringList> m_edges; // from -> [to]
+  QStringList m_names;                 // Einfüge-Reihenfolge
+  QStringList m_order;                 // topologisch sortiert
+  QStringList m_roots;                 // Stufen ohne Vorgänger
+};
+
+// -----------------------------------------------------------------------------
+// Standard-Stufen
+// -----------------------------------------------------------------------------
+
+/// Filterkette (Highpass/Notch/Bandlimit) aus DataProcessingQt
+class DspStage : public PipelineStage {
+public:
+  explicit DspStage(const QString &name = "dsp")
+      : PipelineStage(name, Kind::Dsp) {}
+
+  void setProcessor(DataProcessingQt *processor) { m_processor = processor; }
+  bool process(FrameBlock &block) override;
+
+private:
+  DataProcessingQt *m_processor = nullptr;
+};
+
+/// Ganzzahlige Dezimierung für die Anzeige, spitzenerhaltend: aus je
+/// 2 * factor Frames werden Minimum und Maximum jedes Kanals (in zeitlicher
+/// Reihenfolge) zu zwei Frames. Die Rate sinkt um factor, kurze Spitzen
+/// bleiben sichtbar, und ohne Bandpass entsteht kein Aliasing durch
+/// Auslassen.
+class DecimateStage : public PipelineStage {
+public:
+  explicit DecimateStage(const QString &name = "decimate", int factor = 1)
+      : PipelineStage(name, Kind::Decimate), m_factor(factor) {}
+
+  int factor() const { return m_factor; }
+  void setFactor(int factor);
+  void reset() override { m_fill = 0; }
+  bool process(FrameBlock &block) override;
+
+private:
+  int m_factor = 1;
+  int m_fill = 0;             // Frames in der laufenden Gruppe
+  double m_groupTime = 0.0;   // Zeit des ersten Frames der Gruppe
+  qint64 m_groupIndex = 0;    // und sein Sample-Index
+  QVector<double> m_lo, m_hi; // Extrema der Gruppe je Kanal
+  QVector<int> m_loAt, m_hiAt; // deren Position in der Gruppe
+};
+
+/// Senke bzw. Analysestufe mit beliebigem Callback
+class CallbackStage : public PipelineStage {
+public:
+  using Callback = std::function<void(const FrameBlock &)>;
+
+  CallbackStage(const QString &name, Kind kind, Callback cb,
+                std::function<void()> onReset = {})
+      : PipelineStage(name, kind), m_callback(std::move(cb)),
+        m_onReset(std::move(onReset)) {}
+
+  void reset() override {
+    if (m_onReset)
+      m_onReset();
+  }
+  bool process(FrameBlock &block) override {
+    if (m_callback)
+      m_callback(block);
+    return true;
+  }
+
+private:
+  Callback m_callback;
+  std::function<void()> m_onReset;
+};
+
+#endif // PROCESSINGPIPELINE_H
@@ -89,18 +89,13 @@ void RealDataSource::readUdp() {
     m_lastSenderAddress = sender;
     m_lastSenderPort = port;
 
-    // Check for text response (impedance result)
-    if (buffer.startsWith("IMP:")) {
-      QString text = QString::fromUtf8(buffer).trimmed();
-      QString valuesStr = text.mid(4); // Remove "IMP:"
-      QStringList values = valuesStr.split(',');
-      emit impedanceReceived(values);
+    // Textantwort (Impedanz, Lead-Off-Bestätigung)
+    if (handleResponse(buffer))
       continue;
-    }
 
     // TODO: Hier dein echtes UDP-Protokoll parsen
     // Im Moment: Dummy mit 8 Kanälen = 0
     QVector<double> values(8, 0.0);
-    emit newEEGData(values);
+    publishSample(values);
   }
 }
@@ -0,0 +1,130 @@
+#include "RenderScheduler.h"
+
+#include <QElapsedTimer>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double kSlowerAbove = 0.5;  // Anteil am Budget: Rate senken
+constexpr double kFasterBelow = 0.25; // Anteil am Budget: Rate anheben
+constexpr double kRateStep = 1.25;
+constexpr double kLoadSmoothing = 0.2;
+} // namespace
+
+RenderScheduler::RenderScheduler(const QElapsedTimer *clock, QObject *parent)
+    : QObject(parent), m_clock(clock) {
+  m_timer.setTimerType(Qt::PreciseTimer);
+  connect(&m_timer, &QTimer::timeout, this, &RenderScheduler::onTick);
+  applyInterval();
+}
+
+void RenderScheduler::setTargetFps(double fps) {
+  m_targetFps = std::max(1.0, fps);
+  m_minFps = std::min(m_minFps, m_targetFps);
+  m_currentFps = m_targetFps;
+  applyInterval();
+}
+
+void RenderScheduler::setMinFps(double fps) {
+  m_minFps = qBound(1.0, fps, m_targetFps);
+  m_currentFps = std::max(m_currentFps, m_minFps);
+  applyInterval();
+}
+
+void RenderScheduler::applyInterval() {
+  m_timer.setInterval(std::max(1, qRound(1000.0 / m_currentFps)));
+}
+
+void RenderScheduler::start() {
+  m_lastTickNs = -1;
+  m_timer.start();
+}
+
+void RenderScheduler::stop() { m_timer.stop(); }
+
+void RenderScheduler::markDirty(qint64 arrivalNs) {
+  if (!m_dirty || arrivalNs < m_oldestPendingNs)
+    m_oldestPendingNs = arrivalNs;
+  m_dirty = true;
+}
+
+void RenderScheduler::reset() {
+  m_dirty = false;
+  m_oldestPendingNs = -1;
+  m_lastTickNs = -1;
+  m_loadMs = 0.0;
+  m_currentFps = m_targetFps;
+  applyInterval();
+  takeStats();
+}
+
+RenderScheduler::Stats RenderScheduler::takeStats() {
+  const qint64 now = m_clock->nsecsElapsed();
+  Stats s;
+  s.targetFps = m_currentFps;
+  s.frames = m_frames;
+  s.dropped = m_dropped;
+  if (m_frames > 0) {
+    s.avgFrameMs = m_frameMsSum / m_frames;
+    s.maxFrameMs = m_frameMsMax;
+    s.avgLatencyMs = m_latencyMsSum / m_frames;
+    s.maxLatencyMs = m_latencyMsMax;
+  }
+  if (m_statsStartNs >= 0 && now > m_statsStartNs)
+    s.fps = m_frames * 1e9 / double(now - m_statsStartNs);
+
+  m_statsStartNs = now;
+  m_frames = m_dropped = 0;
+  m_frameMsSum = m_frameMsMax = 0.0;
+  m_latencyMsSum = m_latencyMsMax = 0.0;
+  return s;
+}
+
+void RenderScheduler::onTick() {
+  const qint64 now = m_clock->nsecsElapsed();
+  const double intervalNs = 1e9 / m_currentFps;
+
+  // Ticks, die (z. B. wegen eines langen Frames) ausgefallen sind, zählen
+  // nur als verworfen, wenn Daten darauf gewartet haben
+  if (m_dirty && m_lastTickNs >= 0) {
+    const double slots = std::floor((now - m_lastTickNs) / intervalNs + 0.5);
+    if (slots > 1.0)
+      m_dropped += quint64(slots - 1.0);
+  }
+  m_lastTickNs = now;
+  if (!m_dirty)
+    return;
+
+  const qint64 oldest = m_oldestPendingNs;
+  m_dirty = false;
+  m_oldestPendingNs = -1;
+  emit frame();
+
+  const qint64 end = m_clock->nsecsElapsed();
+  const double frameMs = (end - now) / 1e6;
+  const double latencyMs = oldest >= 0 ? (end - oldest) / 1e6 : frameMs;
+  ++m_frames;
+  m_frameMsSum += frameMs;
+  m_frameMsMax = std::max(m_frameMsMax, frameMs);
+  m_latencyMsSum += latencyMs;
+  m_latencyMsMax = std::max(m_latencyMsMax, latencyMs);
+
+  adapt(frameMs);
+}
+
+void RenderScheduler::adapt(double frameMs) {
+  m_loadMs = (m_loadMs <= 0.0)
+                 ? frameMs
+                 : m_loadMs + kLoadSmoothing * (frameMs - m_loadMs);
+  const double budgetMs = 1000.0 / m_currentFps;
+  double fps = m_currentFps;
+  if (m_loadMs > kSlowerAbove * budgetMs)
+    fps = std::max(m_minFps, m_currentFps / kRateStep);
+  else if (m_loadMs < kFasterBelow * budgetMs)
+    fps = std::min(m_targetFps, m_currentFps * kRateStep);
+  if (fps != m_currentFps) {
+    m_currentFps = fps;
+    applyInterval();
+  }
+}
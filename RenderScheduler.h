@@ -0,0 +1,93 @@
+#ifndef RENDERSCHEDULER_H
+#define RENDERSCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+
+class QElapsedTimer;
+
+/**
+ * Bildtakt für die Live-Ansichten, entkoppelt vom Datenempfang.
+ *
+ * Ein Wanduhr-Timer (Qt::PreciseTimer) tickt mit der Zielrate. Daten, die
+ * zwischen zwei Ticks ankommen, melden nur markDirty(); der nächste Tick
+ * zeichnet alles Ausstehende in einem Frame (Signal frame()). Schübe
+ * erzeugen so keine Replots hintereinander, Pausen keine ausbleibenden.
+ *
+ * Die Rate passt sich an: braucht ein Frame im Mittel mehr als die Hälfte
+ * seines Budgets, wird die Rate gesenkt (bis minFps), bei weniger als einem
+ * Viertel schrittweise wieder bis zur Zielrate angehoben.
+ *
+ * Gemessen werden Frame-Dauer (frame() muss synchron zeichnen), verpasste
+ * Ticks bei ausstehenden Daten und die Latenz von der Ankunft der ältesten
+ * ausstehenden Daten bis zum fertigen Frame (gleicher Takt wie arrivalNs).
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        double  targetFps    = 0.0;  // aktuelle, ggf. abgesenkte Rate
+        double  fps          = 0.0;  // tatsächlich gezeichnete Frames/s
+        double  avgFrameMs   = 0.0;
+        double  maxFrameMs   = 0.0;
+        quint64 frames       = 0;
+        quint64 dropped      = 0;    // verpasste Ticks mit ausstehenden Daten
+        double  avgLatencyMs = 0.0;  // Ankunft -> Frame fertig
+        double  maxLatencyMs = 0.0;
+    };
+
+    explicit RenderScheduler(const QElapsedTimer *clock,
+                             QObject *parent = nullptr);
+
+    void setTargetFps(double fps);
+    double targetFps() const { return m_targetFps; }
+    void setMinFps(double fps);
+    double currentFps() const { return m_currentFps; }
+
+    void start();
+    void stop();
+
+    /// Neue Daten für den nächsten Frame; arrivalNs auf dem gemeinsamen Takt
+    void markDirty(qint64 arrivalNs);
+    bool isDirty() const { return m_dirty; }
+
+    /// Verwirft Ausstehendes, Statistik und Ratenabsenkung
+    void reset();
+
+    /// Statistik seit dem letzten Aufruf
+    Stats takeStats();
+
+signals:
+    /// Alle seit dem letzten Frame angekommenen Daten zeichnen
+    void frame();
+
+private:
+    void onTick();
+    void adapt(double frameMs);
+    void applyInterval();
+
+    const QElapsedTimer *m_clock;
+    QTimer m_timer;
+
+    double m_targetFps  = 30.0;
+    double m_minFps     = 10.0;
+    double m_currentFps = 30.0;
+    double m_loadMs     = 0.0;   // geglättete Frame-Dauer
+
+    bool   m_dirty = false;
+    qint64 m_oldestPendingNs = -1;
+    qint64 m_lastTickNs = -1;
+
+    // Statistik seit takeStats()
+    qint64  m_statsStartNs = -1;
+    quint64 m_frames  = 0;
+    quint64 m_dropped = 0;
+    double  m_frameMsSum   = 0.0;
+    double  m_frameMsMax   = 0.0;
+    double  m_latencyMsSum = 0.0;
+    double  m_latencyMsMax = 0.0;
+};
+
+#endif // RENDERSCHEDULER_H
@@ -0,0 +1,115 @@
+#include "RunningRms.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+RunningRms::RunningRms(int numChannels, double sampleRate, double windowSec,
+                       Mode mode)
+    : m_numChannels(std::max(1, numChannels)), m_sampleRate(sampleRate),
+      m_windowSec(windowSec), m_mode(mode) {
+  design();
+}
+
+void RunningRms::updateSampleRate(double fs) {
+  if (fs <= 0.0 || fs == m_sampleRate)
+    return;
+  m_sampleRate = fs;
+  design();
+}
+
+void RunningRms::setWindowSeconds(double sec) {
+  if (sec <= 0.0 || sec == m_windowSec)
+    return;
+  m_windowSec = sec;
+  design();
+}
+
+void RunningRms::setMode(Mode mode) {
+  if (mode == m_mode)
+    return;
+  m_mode = mode;
+  design();
+}
+
+void RunningRms::design() {
+  m_windowLength = std::max(1, qRound(m_windowSec * m_sampleRate));
+  m_alpha = 1.0 - std::exp(-1.0 / double(m_windowLength));
+
+  m_sumSq.resize(m_numChannels);
+  if (m_mode == Mode::Window)
+    m_delay.resize(m_windowLength * m_numChannels);
+  else
+    m_delay.clear();
+
+  reset();
+}
+
+void RunningRms::reset() {
+  m_sumSq.fill(0.0);
+  m_delay.fill(0.0);
+  m_pos = 0;
+  m_filled = 0;
+  m_sinceResum = 0;
+}
+
+void RunningRms::processBlock(const double *interleaved, int frames,
+                              int stride) {
+  const int C = std::min(m_numChannels, stride);
+  double *sum = m_sumSq.data();
+
+  if (m_mode == Mode::Exponential) {
+    for (int f = 0; f < frames; ++f) {
+      const double *x = interleaved + f * stride;
+      for (int ch = 0; ch < C; ++ch)
+        sum[ch] += m_alpha * (x[ch] * x[ch] - sum[ch]);
+    }
+    m_filled = std::min(m_filled + frames, m_windowLength);
+    return;
+  }
+
+  const int N = m_windowLength;
+  for (int f = 0; f < frames; ++f) {
+    const double *x = interleaved + f * stride;
+    double *slot = m_delay.data() + m_pos * m_numChannels;
+    for (int ch = 0; ch < C; ++ch) {
+      const double sq = x[ch] * x[ch];
+      sum[ch] += sq - slot[ch];
+      slot[ch] = sq;
+    }
+    if (++m_pos >= N)
+      m_pos = 0;
+    if (m_filled < N)
+      ++m_filled;
+
+    // Einmal pro Fensterlänge exakt neu aufaddieren
+    if (++m_sinceResum >= N)
+      resum();
+  }
+}
+
+void RunningRms::resum() {
+  m_sinceResum = 0;
+  m_sumSq.fill(0.0);
+  const double *d = m_delay.constData();
+  double *sum = m_sumSq.data();
+  for (int i = 0; i < m_windowLength; ++i)
+    for (int ch = 0; ch < m_numChannels; ++ch)
+      sum[ch] += d[i * m_numChannels + ch];
+}
+
+double RunningRms::rms(int channel) const {
+  if (channel < 0 || channel >= m_numChannels || m_filled == 0)
+    return 0.0;
+  const double meanSq = (m_mode == Mode::Window)
+                            ? m_sumSq[channel] / double(m_filled)
+                            : m_sumSq[channel];
+  return std::sqrt(std::max(0.0, meanSq));
+}
+
+QVector<double> RunningRms::rmsAll() const {
+  QVector<double> out(m_numChannels);
+  for (int ch = 0; ch < m_numChannels; ++ch)
+    out[ch] = rms(ch);
+  return out;
+}
@@ -0,0 +1,65 @@
+#ifndef RUNNINGRMS_H
+#define RUNNINGRMS_H
+
+#include <QVector>
+
+/**
+ * Gleitender Effektivwert pro Kanal für die Head-Map.
+ *
+ * - Window: Rechteckfenster über windowSec; die Quadratsumme wird pro
+ *   Sample um x[n]^2 - x[n-N]^2 nachgeführt (O(1) pro Sample und Kanal)
+ *   und einmal pro Fensterlänge neu aufaddiert (Rundungsdrift)
+ * - Exponential: exponentiell gewichtetes Mittel der Quadrate mit
+ *   Zeitkonstante windowSec, ohne Verzögerungsleitung
+ *
+ * Abfragen kosten nur eine Wurzel pro Kanal und sind damit in jeder Rate
+ * bis zur Bildwiederholrate praktisch kostenlos.
+ */
+class RunningRms
+{
+public:
+    enum class Mode { Window, Exponential };
+
+    RunningRms(int numChannels,
+               double sampleRate,
+               double windowSec = 2.0,
+               Mode mode = Mode::Window);
+
+    void updateSampleRate(double fs);
+    void setWindowSeconds(double sec);
+    double windowSeconds() const { return m_windowSec; }
+    void setMode(Mode mode);
+    Mode mode() const { return m_mode; }
+
+    void reset();
+
+    /// frames Frames aus einem interleavten Block (stride = Kanäle im Block)
+    void processBlock(const double *interleaved, int frames, int stride);
+
+    /// true, sobald ein komplettes Fenster (bzw. eine Zeitkonstante) vorliegt
+    bool isReady() const { return m_filled >= m_windowLength; }
+
+    /// Effektivwert (µV) eines Kanals
+    double rms(int channel) const;
+    QVector<double> rmsAll() const;
+
+private:
+    void design();
+    void resum();
+
+    int    m_numChannels  = 0;
+    double m_sampleRate   = 250.0;
+    double m_windowSec    = 2.0;
+    Mode   m_mode         = Mode::Window;
+
+    int    m_windowLength = 0;   // N
+    double m_alpha        = 0.0; // Exponential: 1 - e^{-1/N}
+
+    QVector<double> m_sumSq;     // je Kanal: Summe (Window) bzw. Mittel (Exp.)
+    QVector<double> m_delay;     // Window: [pos * channels + ch], N Frames
+    int    m_pos          = 0;
+    int    m_filled       = 0;
+    int    m_sinceResum   = 0;
+};
+
+#endif // RUNNINGRMS_H
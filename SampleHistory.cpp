@@ -0,0 +1,77 @@
+#include "SampleHistory.h"
+
+#include <algorithm>
+
+namespace {
+constexpr int kDoublesPerLine = 64 / int(sizeof(double));
+} // namespace
+
+SampleHistory::SampleHistory(int channels, int capacity) {
+  configure(channels, capacity);
+}
+
+void SampleHistory::configure(int channels, int capacity) {
+  m_channels = std::max(0, channels);
+  m_capacity = std::max(1, capacity);
+  m_rowStride =
+      (m_capacity + kDoublesPerLine - 1) / kDoublesPerLine * kDoublesPerLine;
+  m_data.resize(m_channels * m_rowStride);
+  std::fill(m_data.data(), m_data.data() + m_data.size(), 0.0);
+  m_total.store(0, std::memory_order_release);
+}
+
+void SampleHistory::append(const double *interleaved, int frames, int stride) {
+  if (frames <= 0 || m_channels == 0)
+    return;
+
+  const qint64 total = m_total.load(std::memory_order_relaxed);
+  int slot = int(total % m_capacity);
+  double *base = m_data.data();
+  for (int f = 0; f < frames; ++f) {
+    const double *frame = interleaved + f * stride;
+    for (int ch = 0; ch < m_channels; ++ch)
+      base[ch * m_rowStride + slot] = frame[ch];
+    if (++slot == m_capacity)
+      slot = 0;
+  }
+
+  // Erst die Daten, dann der Index (Leser in anderen Threads)
+  m_total.store(total + frames, std::memory_order_release);
+}
+
+qint64 SampleHistory::oldestIndex() const {
+  return std::max<qint64>(0, totalSamples() - m_capacity);
+}
+
+bool SampleHistory::contains(qint64 from) const {
+  return from >= oldestIndex();
+}
+
+SampleHistory::View SampleHistory::view(int channel, qint64 from,
+                                        int count) const {
+  View v;
+  if (channel < 0 || channel >= m_channels || count <= 0)
+    return v;
+
+  const qint64 total = totalSamples();
+  const qint64 begin = std::max(from, std::max<qint64>(0, total - m_capacity));
+  const qint64 end = std::min(from + count, total);
+  v.start = begin;
+  if (end <= begin)
+    return v;
+
+  const double *row = m_data.data() + channel * m_rowStride;
+  const int slot = int(begin % m_capacity);
+  const int n = int(end - begin);
+  v.first.data = row + slot;
+  v.first.size = std::min(n, m_capacity - slot);
+  if (v.first.size < n) {
+    v.second.data = row;
+    v.second.size = n - v.first.size;
+  }
+  return v;
+}
+
+SampleHistory::View SampleHistory::latest(int channel, int count) const {
+  return view(channel, totalSamples() - count, count);
+}
@@ -0,0 +1,82 @@
+#ifndef SAMPLEHISTORY_H
+#define SAMPLEHISTORY_H
+
+#include "FftPlan.h" // AlignedBuffer
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * Gemeinsamer Verlauf aller Kanäle (Ausgang der DSP-Kette).
+ *
+ * Pro Kanal ein vorallozierter Ring fester Kapazität, alle Kanäle in einem
+ * 64-Byte-ausgerichteten Block. Anhängen ist O(1) pro Sample und allokiert
+ * nie. Jedes Sample hat einen monoton steigenden Index (0 = erstes Sample
+ * nach configure()); Leser fordern beliebige Fenster [from, from + count)
+ * an und bekommen sie ohne Kopie als höchstens zwei zusammenhängende
+ * Stücke (getrennt am Umbruch des Rings).
+ *
+ * Geschrieben wird nur aus einem Thread. Andere Threads dürfen Indizes
+ * < totalSamples() lesen, aber nur Plätze, die der Schreiber währenddessen
+ * nicht überschreibt: Lesen und Schreiben desselben Platzes wäre ein Data
+ * Race, auch wenn contains() es hinterher bemerkt. Der Schreiber stimmt
+ * sich deshalb vor append() mit den Lesern ab
+ * (SpectralAnalyzer::reserveHistory).
+ */
+class SampleHistory
+{
+public:
+    struct Span {
+        const double *data = nullptr;
+        int size = 0;
+    };
+
+    /// Fenster eines Kanals: first, danach second (leer ohne Umbruch)
+    struct View {
+        Span first;
+        Span second;
+        qint64 start = 0; // Index von first.data[0]
+
+        int size() const { return first.size + second.size; }
+        bool isEmpty() const { return size() == 0; }
+        double operator[](int i) const
+        {
+            return i < first.size ? first.data[i] : second.data[i - first.size];
+        }
+    };
+
+    SampleHistory() = default;
+    SampleHistory(int channels, int capacity);
+
+    /// Verwirft den Inhalt und setzt den Index auf 0 (nur ohne Leser!)
+    void configure(int channels, int capacity);
+    int channels() const { return m_channels; }
+    int capacity() const { return m_capacity; }
+
+    /// frames Frames aus einem interleavten Block (stride >= channels)
+    void append(const double *interleaved, int frames, int stride);
+
+    /// Index des nächsten Samples = Anzahl bisher geschriebener Frames
+    qint64 totalSamples() const
+    {
+        return m_total.load(std::memory_order_acquire);
+    }
+    /// Ältester noch gespeicherter Index
+    qint64 oldestIndex() const;
+    /// true, solange Index from noch nicht überschrieben ist
+    bool contains(qint64 from) const;
+
+    /// Sicht auf [from, from + count), begrenzt auf den gespeicherten Bereich
+    View view(int channel, qint64 from, int count) const;
+    /// Die jüngsten count Samples eines Kanals
+    View latest(int channel, int count) const;
+
+private:
+    int m_channels  = 0;
+    int m_capacity  = 0;
+    int m_rowStride = 0;          // Kapazität auf volle Cache-Lines aufgerundet
+    AlignedBuffer<double> m_data; // [channel * rowStride + slot]
+    std::atomic<qint64> m_total{0};
+};
+
+#endif // SAMPLEHISTORY_H
@@ -0,0 +1,132 @@
+#include "SlidingRange.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SlidingRange::configure(int window, int chunks) {
+  m_window = std::max(1, window);
+  m_chunks = qBound(1, chunks, m_window);
+  m_chunkLen = (m_window + m_chunks - 1) / m_chunks;
+  // Jeder Eintrag liegt im Fenster: höchstens window je Deque
+  m_minQ.resize(m_window);
+  m_maxQ.resize(m_window);
+  // Teilweise hinausgeschobener ältester Block + laufender Block
+  m_chunkLo.fill(0.0, m_chunks + 1);
+  m_chunkHi.fill(0.0, m_chunks + 1);
+  m_scratch.reserve(m_chunks + 1);
+  reset();
+}
+
+void SlidingRange::reset() {
+  m_count = 0;
+  m_minHead = m_minTail = m_minSize = 0;
+  m_maxHead = m_maxTail = m_maxSize = 0;
+  m_chunkSlot = 0;
+  m_chunkFill = 0;
+}
+
+void SlidingRange::append(const double *values, int count, int stride) {
+  for (int i = 0; i < count; ++i)
+    append(values[i * stride]);
+}
+
+void SlidingRange::append(double value) {
+  if (m_window == 0)
+    return;
+  const int W = m_window;
+  const qint64 index = m_count++;
+  const qint64 expired = m_count - W; // Indizes darunter fallen heraus
+  auto prev = [W](int pos) { return pos == 0 ? W - 1 : pos - 1; };
+  auto next = [W](int pos) { return pos + 1 == W ? 0 : pos + 1; };
+
+  // Min-Deque: Werte aufsteigend; größere oder gleiche hinten verdrängen
+  while (m_minSize > 0 && !(m_minQ[prev(m_minTail)].value < value)) {
+    m_minTail = prev(m_minTail);
+    --m_minSize;
+  }
+  if (m_minSize > 0 && m_minQ[m_minHead].index < expired) {
+    m_minHead = next(m_minHead);
+    --m_minSize;
+  }
+  m_minQ[m_minTail] = {index, value};
+  m_minTail = next(m_minTail);
+  ++m_minSize;
+
+  // Max-Deque: Werte absteigend
+  while (m_maxSize > 0 && !(m_maxQ[prev(m_maxTail)].value > value)) {
+    m_maxTail = prev(m_maxTail);
+    --m_maxSize;
+  }
+  if (m_maxSize > 0 && m_maxQ[m_maxHead].index < expired) {
+    m_maxHead = next(m_maxHead);
+    --m_maxSize;
+  }
+  m_maxQ[m_maxTail] = {index, value};
+  m_maxTail = next(m_maxTail);
+  ++m_maxSize;
+
+  // Block-Extrema
+  if (m_chunkFill == m_chunkLen) {
+    m_chunkSlot = (m_chunkSlot == m_chunks) ? 0 : m_chunkSlot + 1;
+    m_chunkFill = 0;
+  }
+  if (m_chunkFill++ == 0) {
+    m_chunkLo[m_chunkSlot] = m_chunkHi[m_chunkSlot] = value;
+  } else {
+    m_chunkLo[m_chunkSlot] = std::min(m_chunkLo[m_chunkSlot], value);
+    m_chunkHi[m_chunkSlot] = std::max(m_chunkHi[m_chunkSlot], value);
+  }
+}
+
+const SlidingRange::Entry &SlidingRange::firstFrom(const QVector<Entry> &q,
+                                                   int head, int size,
+                                                   qint64 first) {
+  // Indizes aufsteigend: binäre Suche über die Ringpositionen
+  const int W = q.size();
+  int lo = 0, hi = size - 1; // der jüngste Eintrag erfüllt es immer
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (q[(head + mid) % W].index >= first)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return q[(head + lo) % W];
+}
+
+void SlidingRange::rangeOfLast(int n, double &lo, double &hi) const {
+  n = qBound(1, n, size());
+  const qint64 first = m_count - n;
+  lo = firstFrom(m_minQ, m_minHead, m_minSize, first).value;
+  hi = firstFrom(m_maxQ, m_maxHead, m_maxSize, first).value;
+}
+
+void SlidingRange::robustRange(double &lo, double &hi, double quantile) const {
+  if (isEmpty()) {
+    lo = hi = 0.0;
+    return;
+  }
+  // Blöcke, die ins Fenster reichen (der älteste evtl. nur teilweise)
+  const qint64 newest = (m_count - 1) / m_chunkLen;
+  const qint64 oldest = std::max<qint64>(0, m_count - m_window) / m_chunkLen;
+  const int n = int(newest - oldest + 1);
+  const int trim = std::min(
+      int(std::ceil((1.0 - qBound(0.5, quantile, 1.0)) * n - 1e-9)),
+      (n - 1) / 2);
+
+  // Der jüngste Block liegt in m_chunkSlot, ältere davor (Ring)
+  const int slots = m_chunks + 1;
+  const int first = (m_chunkSlot - (n - 1) + slots) % slots;
+  m_scratch.resize(n);
+  for (int k = 0; k < n; ++k)
+    m_scratch[k] = m_chunkHi[(first + k) % slots];
+  std::nth_element(m_scratch.begin(), m_scratch.end() - 1 - trim,
+                   m_scratch.end());
+  hi = *(m_scratch.end() - 1 - trim);
+
+  for (int k = 0; k < n; ++k)
+    m_scratch[k] = m_chunkLo[(first + k) % slots];
+  std::nth_element(m_scratch.begin(), m_scratch.begin() + trim,
+                   m_scratch.end());
+  lo = *(m_scratch.begin() + trim);
+}
@@ -0,0 +1,76 @@
+#ifndef SLIDINGRANGE_H
+#define SLIDINGRANGE_H
+
+#include <QVector>
+#include <QtGlobal>
+#include <algorithm>
+
+/**
+ * Gleitendes Minimum/Maximum einer Live-Spur für die Autoskala.
+ *
+ * - Exakt: zwei monotone Deques (Ringpuffer fester Kapazität) über die
+ *   letzten window Samples. Jedes Sample wird höchstens einmal eingefügt
+ *   und entfernt (O(1) amortisiert pro Sample, ohne Allokation). Die
+ *   Einträge sind nach Index aufsteigend und nach Wert monoton, daher
+ *   liefert min()/max() das ganze Fenster in O(1) und rangeOfLast() jedes
+ *   jüngste Teilstück per binärer Suche.
+ * - Robust: Minimum/Maximum je Block (chunks Blöcke über das Fenster).
+ *   robustRange() verwirft die extremsten Blöcke (Quantil über die
+ *   Block-Extrema), ein kurzer Elektroden-Pop staucht die Spur so nicht.
+ *   Kosten O(chunks), unabhängig von Fensterlänge und Abtastrate.
+ */
+class SlidingRange
+{
+public:
+    /// Fensterlänge in Samples und Zahl der Blöcke; leert
+    void configure(int window, int chunks = 32);
+    int window() const { return m_window; }
+
+    void reset();
+
+    /// count Werte (values[i * stride])
+    void append(const double *values, int count, int stride = 1);
+    void append(double value);
+
+    bool isEmpty() const { return m_count == 0; }
+    /// Samples im Fenster
+    int size() const { return int(std::min<qint64>(m_count, m_window)); }
+
+    /// Über das ganze Fenster (nur wenn !isEmpty())
+    double min() const { return m_minQ[m_minHead].value; }
+    double max() const { return m_maxQ[m_maxHead].value; }
+    /// Über die jüngsten n Samples (1 <= n <= size())
+    void rangeOfLast(int n, double &lo, double &hi) const;
+
+    /// Quantil der Block-Minima/-Maxima (quantile = 0.95: oben und unten
+    /// je ceil(5 %) der Blöcke verwerfen)
+    void robustRange(double &lo, double &hi, double quantile = 0.95) const;
+
+private:
+    struct Entry {
+        qint64 index;
+        double value;
+    };
+
+    /// Erster Eintrag (ältester) mit Index >= first in einer Deque
+    static const Entry &firstFrom(const QVector<Entry> &q, int head,
+                                  int size, qint64 first);
+
+    int    m_window = 0;
+    qint64 m_count  = 0;            // laufender Index hinter dem jüngsten
+
+    QVector<Entry> m_minQ;          // Werte aufsteigend
+    QVector<Entry> m_maxQ;          // Werte absteigend
+    int m_minHead = 0, m_minTail = 0, m_minSize = 0;
+    int m_maxHead = 0, m_maxTail = 0, m_maxSize = 0;
+
+    int m_chunks   = 0;
+    int m_chunkLen = 1;             // Samples je Block
+    QVector<double> m_chunkLo;      // Ring über die Blöcke, jüngster zuletzt
+    QVector<double> m_chunkHi;
+    int m_chunkSlot = 0;            // Ringposition des laufenden Blocks
+    int m_chunkFill = 0;            // Samples im laufenden Block
+    mutable QVector<double> m_scratch;
+};
+
+#endif // SLIDINGRANGE_H
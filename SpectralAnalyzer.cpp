@@ -0,0 +1,359 @@
+#include "SpectralAnalyzer.h"
+#include "SampleHistory.h"
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace {
+// Obergrenze für nicht abgeholte Spektrogramm-Spalten (GUI hängt)
+constexpr int kMaxQueuedColumns = 256;
+// Anteil des Verlaufs zwischen ältestem Index und dem, was Jobs lesen
+constexpr double kGuardFraction = 0.25;
+} // namespace
+
+struct SpectralAnalyzer::SpectrumWorker {
+  SpectrumWorker(double fs, const WelchEstimator::Config &config, int channels)
+      : estimator(fs, config, channels), matrix(channels) {}
+
+  WelchEstimator estimator; // alle Kanäle, eine Batch-FFT pro Segment
+  BandPowerMatrix matrix;
+  quint64 version = 0;
+  quint64 generation = 0;
+
+  // Zoom-Spektrum (Chirp-Z), gleiche Segmente wie estimator
+  std::unique_ptr<WelchEstimator> zoom;
+  double zoomMaxHz = 0.0;
+  double zoomStepHz = 0.0;
+  quint64 zoomVersion = 0;
+
+  // Kreuzspektren aus den Segment-FFTs von estimator (nur wenn aktiviert)
+  std::unique_ptr<ConnectivityEstimator> connectivity;
+};
+
+struct SpectralAnalyzer::SpectrogramWorker {
+  std::unique_ptr<WelchEstimator> estimator;
+  quint64 version = 0;
+};
+
+SpectralAnalyzer::SpectralAnalyzer(const SampleHistory *history,
+                                   int numChannels, QObject *parent)
+    : QObject(parent), m_history(history), m_numChannels(numChannels),
+      m_spectrumWorker(
+          new SpectrumWorker(m_sampleRate, m_welchConfig, numChannels)),
+      m_spectrogramWorker(new SpectrogramWorker) {
+  // Ein Thread je Analyseart genügt: pro Art ist nie mehr als ein Job aktiv
+  m_pool.setMaxThreadCount(JobTypeCount);
+
+  // Spektrum und Spektrogramm teilen sich Segmente gleicher Spec
+  m_spectrumWorker->estimator.setCache(&m_cache, 0);
+}
+
+SpectralAnalyzer::~SpectralAnalyzer() {
+  // Laufende Jobs greifen auf die Worker zu
+  m_pool.waitForDone();
+}
+
+void SpectralAnalyzer::setSampleRate(double fs) {
+  if (fs <= 0.0 || fs == m_sampleRate)
+    return;
+  m_sampleRate = fs;
+  ++m_slots[SpectrumJob].version;
+  ++m_slots[SpectrogramJob].version;
+}
+
+void SpectralAnalyzer::setWelchConfig(const WelchEstimator::Config &config) {
+  m_welchConfig = config;
+  ++m_slots[SpectrumJob].version;
+}
+
+void SpectralAnalyzer::setZoom(double maxHz, double stepHz) {
+  // Kein neuer Einstellungsstand: das normale Spektrum läuft ungestört weiter
+  m_zoomMaxHz = (maxHz > 0.0 && stepHz > 0.0) ? maxHz : 0.0;
+  m_zoomStepHz = (maxHz > 0.0 && stepHz > 0.0) ? stepHz : 0.0;
+}
+
+void SpectralAnalyzer::setConnectivity(bool enabled) {
+  // Wie der Zoom: Welch-Mittelung läuft ungestört weiter
+  m_connectivity = enabled;
+}
+
+void SpectralAnalyzer::setSpectrogram(const WelchEstimator::Config &config,
+                                      int channel) {
+  m_spectrogramConfig = config;
+  m_spectrogramChannel = channel;
+  ++m_slots[SpectrogramJob].version;
+  m_columnQueue.clear();
+}
+
+void SpectralAnalyzer::reset() {
+  for (Slot &slot : m_slots) {
+    slot.cursor = m_history->totalSamples();
+    ++slot.version; // laufende Jobs liefern danach verworfene Ergebnisse
+  }
+  std::atomic_store(&m_spectrum, std::shared_ptr<const SpectrumResult>());
+  m_columnQueue.clear();
+  // Schlüssel sind Verlaufsindizes; nach SampleHistory::configure beginnen
+  // die wieder bei 0 und träfen sonst Periodogramme des alten Laufs
+  m_cache.clear();
+}
+
+int SpectralAnalyzer::minJobFrames() const {
+  // Keine Mini-Jobs pro Sample: frühestens alle ~50 ms
+  return std::max(1, int(m_sampleRate / 20.0));
+}
+
+void SpectralAnalyzer::waitForJobs() { m_pool.waitForDone(); }
+
+void SpectralAnalyzer::reserveHistory(int frames) {
+  // Überschrieben werden die Indizes unterhalb von total + frames - capacity
+  const qint64 overwritten =
+      m_history->totalSamples() + frames - m_history->capacity();
+  for (const Slot &slot : m_slots) {
+    if (slot.busy && slot.readFrom < overwritten) {
+      waitForJobs();
+      return;
+    }
+  }
+}
+
+int SpectralAnalyzer::pendingFrames(Slot &slot) const {
+  // Mehr als der Verlauf hält, ist verloren (Job hing zu lange); der
+  // Abstand zum ältesten Index lässt dem Schreiber Platz, bevor er warten
+  // müsste
+  const int guard = int(m_history->capacity() * kGuardFraction);
+  slot.cursor = std::max(slot.cursor, m_history->totalSamples() -
+                                          m_history->capacity() + guard);
+  return int(std::max<qint64>(0, m_history->totalSamples() - slot.cursor));
+}
+
+void SpectralAnalyzer::dispatch() {
+  const int minFrames = minJobFrames();
+  if (!m_slots[SpectrumJob].busy &&
+      pendingFrames(m_slots[SpectrumJob]) >= minFrames)
+    startSpectrumJob();
+  if (!m_slots[SpectrogramJob].busy &&
+      pendingFrames(m_slots[SpectrogramJob]) >= minFrames)
+    startSpectrogramJob();
+}
+
+void SpectralAnalyzer::startSpectrumJob() {
+  Slot &slot = m_slots[SpectrumJob];
+  slot.busy = true;
+
+  // Indexbereich + Einstellungen gehen als Kopie in den Job; die Samples
+  // liest er direkt aus dem Verlauf
+  const int frames = pendingFrames(slot); // rückt den Cursor ggf. vor
+  const qint64 from = slot.cursor;
+  slot.cursor += frames;
+  slot.readFrom = from;
+  const quint64 version = slot.version;
+  const SampleHistory *history = m_history;
+  const double fs = m_sampleRate;
+  const WelchEstimator::Config config = m_welchConfig;
+  const double zoomMaxHz = m_zoomMaxHz;
+  const double zoomStepHz = m_zoomStepHz;
+  const bool connectivity = m_connectivity;
+  const int channels = m_numChannels;
+  SpectrumWorker *w = m_spectrumWorker.get();
+
+  m_pool.start([=]() {
+    QElapsedTimer timer;
+    timer.start();
+
+    if (w->version != version) {
+      w->estimator.setSampleRate(fs);
+      w->estimator.setConfig(config); // setzt auch zurück
+      w->matrix.reset();
+      if (w->connectivity)
+        w->connectivity->reset();
+      w->version = version;
+    }
+    if (w->estimator.streamIndex() != from) {
+      // Lücke (Reset, verlorene Samples): am Verlaufsindex neu aufsetzen
+      w->estimator.reset();
+      w->estimator.setStreamIndex(from);
+      w->matrix.reset();
+      if (w->connectivity)
+        w->connectivity->reset();
+    }
+
+    w->estimator.setKeepSpectra(connectivity);
+    if (!connectivity) {
+      w->connectivity.reset();
+    } else if (!w->connectivity) {
+      w->connectivity.reset(new ConnectivityEstimator(channels));
+    }
+    if (w->connectivity)
+      w->connectivity->setAverages(config.averages);
+
+    if (zoomMaxHz <= 0.0) {
+      w->zoom.reset();
+    } else if (!w->zoom || w->zoomVersion != version ||
+               w->zoomMaxHz != zoomMaxHz || w->zoomStepHz != zoomStepHz) {
+      WelchEstimator::Config zoomConfig = config;
+      zoomConfig.zoomMaxHz = zoomMaxHz;
+      zoomConfig.zoomStepHz = zoomStepHz;
+      w->zoom.reset(new WelchEstimator(fs, zoomConfig, channels));
+      w->zoom->setCache(&m_cache, 0); // eigenes Raster -> eigene Schlüssel
+      w->zoomMaxHz = zoomMaxHz;
+      w->zoomStepHz = zoomStepHz;
+      w->zoomVersion = version;
+    }
+    if (w->zoom && w->zoom->streamIndex() != from) {
+      w->zoom->reset();
+      w->zoom->setStreamIndex(from);
+    }
+
+    // Alle Kanäle wrappen an derselben Stelle: höchstens zwei Stücke
+    QVector<SampleHistory::View> views(channels);
+    for (int ch = 0; ch < channels; ++ch)
+      views[ch] = history->view(ch, from, frames);
+    QVector<const double *> planes(channels);
+    QVector<const double *> chunk(channels);
+    const int hop = w->estimator.hopLength();
+    int segments = 0;
+    for (int part = 0; part < 2; ++part) {
+      for (int ch = 0; ch < channels; ++ch)
+        planes[ch] = part == 0 ? views[ch].first.data : views[ch].second.data;
+      const int n = part == 0 ? views[0].first.size : views[0].second.size;
+      if (n <= 0)
+        continue;
+      if (w->zoom)
+        w->zoom->append(planes.constData(), n);
+      if (!w->connectivity) {
+        segments += w->estimator.append(planes.constData(), n);
+        continue;
+      }
+      // In Hop-Stücken: die Kreuzspektren brauchen jedes Segment einzeln
+      for (int off = 0; off < n; off += hop) {
+        for (int ch = 0; ch < channels; ++ch)
+          chunk[ch] = planes[ch] + off;
+        if (w->estimator.append(chunk.constData(), std::min(hop, n - off)) >
+            0) {
+          w->connectivity->addSegment(w->estimator);
+          ++segments;
+        }
+      }
+    }
+
+    if (segments > 0 && w->matrix.update(w->estimator)) {
+      auto result = std::make_shared<SpectrumResult>(channels);
+      result->psd.resize(channels);
+      for (int ch = 0; ch < channels; ++ch)
+        result->psd[ch] = w->estimator.psd(ch);
+      result->binHz = w->estimator.binHz();
+      if (w->zoom && w->zoom->isReady()) {
+        result->zoomPsd.resize(channels);
+        for (int ch = 0; ch < channels; ++ch)
+          result->zoomPsd[ch] = w->zoom->psd(ch);
+        result->zoomBinHz = w->zoom->binHz();
+      }
+      if (w->connectivity)
+        result->connectivity = w->connectivity->compute();
+      result->bands = w->matrix;
+      result->generation = ++w->generation;
+      result->version = version;
+      std::atomic_store(&m_spectrum,
+                        std::shared_ptr<const SpectrumResult>(result));
+    }
+
+    const double us = timer.nsecsElapsed() / 1000.0;
+    QMetaObject::invokeMethod(
+        this, [this, us]() { jobFinished(SpectrumJob, us); },
+        Qt::QueuedConnection);
+  });
+}
+
+void SpectralAnalyzer::startSpectrogramJob() {
+  Slot &slot = m_slots[SpectrogramJob];
+  slot.busy = true;
+
+  const int frames = pendingFrames(slot); // rückt den Cursor ggf. vor
+  const qint64 from = slot.cursor;
+  slot.cursor += frames;
+  slot.readFrom = from;
+  const quint64 version = slot.version;
+  const SampleHistory *history = m_history;
+  const double fs = m_sampleRate;
+  const WelchEstimator::Config config = m_spectrogramConfig;
+  const int channel = qBound(0, m_spectrogramChannel, m_numChannels - 1);
+  SpectrogramWorker *w = m_spectrogramWorker.get();
+
+  m_pool.start([=]() {
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!w->estimator || w->version != version) {
+      w->estimator.reset(new WelchEstimator(fs, config));
+      w->estimator->setCache(&m_cache, channel);
+      w->version = version;
+    }
+    if (w->estimator->streamIndex() != from) {
+      w->estimator->reset();
+      w->estimator->setStreamIndex(from);
+    }
+
+    // In Hop-Stücken anhängen: höchstens ein Segment pro Stück, so dass
+    // jedes Segment eine eigene Spalte ergibt
+    auto result = std::make_shared<SpectrogramResult>();
+    const int hop = w->estimator->hopLength();
+    const SampleHistory::View view = history->view(channel, from, frames);
+    for (const SampleHistory::Span &span : {view.first, view.second}) {
+      for (int off = 0; off < span.size; off += hop) {
+        const int n = std::min(hop, span.size - off);
+        if (w->estimator->append(span.data + off, n) > 0)
+          result->columns.append(w->estimator->psd());
+      }
+    }
+    result->binHz = w->estimator->binHz();
+    result->version = version;
+    std::atomic_store(&m_spectrogram,
+                      std::shared_ptr<const SpectrogramResult>(result));
+
+    const double us = timer.nsecsElapsed() / 1000.0;
+    QMetaObject::invokeMethod(
+        this, [this, us]() { jobFinished(SpectrogramJob, us); },
+        Qt::QueuedConnection);
+  });
+}
+
+void SpectralAnalyzer::jobFinished(int type, double us) {
+  Slot &slot = m_slots[type];
+  slot.busy = false;
+
+  if (type == SpectrumJob) {
+    m_lastSpectrumUs = us;
+  } else {
+    m_lastSpectrogramUs = us;
+    auto result = std::atomic_exchange(
+        &m_spectrogram, std::shared_ptr<const SpectrogramResult>());
+    if (result && result->version == slot.version &&
+        !result->columns.isEmpty()) {
+      m_columnQueue += result->columns;
+      m_columnBinHz = result->binHz;
+      if (m_columnQueue.size() > kMaxQueuedColumns)
+        m_columnQueue.remove(0, m_columnQueue.size() - kMaxQueuedColumns);
+    }
+  }
+
+  // Was während des Jobs eingelaufen ist, geht gesammelt in den nächsten
+  dispatch();
+}
+
+std::shared_ptr<const SpectralAnalyzer::SpectrumResult>
+SpectralAnalyzer::spectrum() const {
+  auto result = std::atomic_load(&m_spectrum);
+  if (result && result->version != m_slots[SpectrumJob].version)
+    return {}; // stammt noch von alten Einstellungen
+  return result;
+}
+
+QVector<QVector<double>> SpectralAnalyzer::takeSpectrogramColumns(
+    double *binHz) {
+  if (binHz)
+    *binHz = m_columnBinHz;
+  return std::exchange(m_columnQueue, {});
+}
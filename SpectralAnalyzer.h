@@ -0,0 +1,154 @@
+#ifndef SPECTRALANALYZER_H
+#define SPECTRALANALYZER_H
+
+#include "BandPowerMatrix.h"
+#include "ConnectivityEstimator.h"
+#include "SpectralCache.h"
+#include "WelchEstimator.h"
+
+class SampleHistory;
+
+#include <QObject>
+#include <QThreadPool>
+#include <QVector>
+#include <memory>
+
+/**
+ * Spektralanalyse im Thread-Pool statt im GUI-Thread.
+ *
+ * Die Samples kommen aus dem gemeinsamen SampleHistory; der GUI-Thread
+ * stößt nur Jobs an (dispatch). Jeder Job bekommt den Indexbereich seit dem
+ * letzten Job plus eine Kopie der aktuellen Einstellungen und liest die
+ * Samples direkt aus dem Verlauf. Pro Analyseart (Spektrum, Spektrogramm)
+ * ist höchstens ein Job unterwegs; was währenddessen ankommt, wird zum
+ * nächsten Job zusammengefasst statt eingereiht.
+ *
+ * Ein Job liest höchstens bis auf ein Viertel der Verlaufskapazität an den
+ * ältesten Index heran; der Schreiber ruft vorher reserveHistory() und
+ * überschreibt so nie Plätze, die noch gelesen werden (wartet nur, wenn ein
+ * Job länger hängt, als der Abstand an Samples hält).
+ *
+ * Die Schätzer gehören dem jeweiligen Job-Typ und werden nur von dessen
+ * (serialisierten) Jobs angefasst. Ergebnisse werden als shared_ptr auf
+ * const atomar veröffentlicht; die Plots holen sie beim nächsten Frame ab.
+ */
+class SpectralAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Welch-PSD aller Kanäle + Bandpower-Matrix (unveränderlich)
+    struct SpectrumResult {
+        QVector<QVector<double>> psd;   // [channel][bin], µV²/Hz
+        double          binHz = 0.0;
+        // Zoom-Spektrum 0 .. zoomMaxHz (leer, solange Zoom aus/nicht bereit)
+        QVector<QVector<double>> zoomPsd;
+        double          zoomBinHz = 0.0;
+        BandPowerMatrix bands;
+        // Kohärenz/PLV je Band (ungültig, solange abgeschaltet/nicht bereit)
+        ConnectivityEstimator::Matrix connectivity;
+        quint64         generation = 0; // zählt je veröffentlichtem Ergebnis
+        quint64         version    = 0; // Einstellungsstand des Jobs
+
+        explicit SpectrumResult(int channels) : bands(channels) {}
+    };
+
+    SpectralAnalyzer(const SampleHistory *history, int numChannels,
+                     QObject *parent = nullptr);
+    ~SpectralAnalyzer() override;
+
+    // Einstellungen (GUI-Thread); wirken ab dem nächsten Job
+    void setSampleRate(double fs);
+    void setWelchConfig(const WelchEstimator::Config &config);
+    void setSpectrogram(const WelchEstimator::Config &config, int channel);
+    /// Zusätzlich Chirp-Z-Spektrum 0 .. maxHz im Raster stepHz (0 = aus)
+    void setZoom(double maxHz, double stepHz);
+    /// Kreuzspektren aller Kanalpaare mitführen (Kohärenz, PLV)
+    void setConnectivity(bool enabled);
+
+    /// Verwirft alle Zwischenstände, veröffentlichten Ergebnisse und den
+    /// Periodogramm-Cache; ausgewertet wird erst wieder, was danach im
+    /// Verlauf ankommt
+    void reset();
+
+    /// Startet Jobs für freie Analysearten mit genug neuen Daten
+    void dispatch();
+    /// Blockiert, bis kein Job mehr aus dem Verlauf liest
+    /// (vor SampleHistory::configure)
+    void waitForJobs();
+    /// Vor SampleHistory::append (GUI-Thread): würden frames neue Samples
+    /// Ringplätze überschreiben, die ein laufender Job noch liest, wird
+    /// vorher auf die Jobs gewartet
+    void reserveHistory(int frames);
+
+    /// Jüngstes Spektrum (nullptr, solange keins zum aktuellen Stand vorliegt)
+    std::shared_ptr<const SpectrumResult> spectrum() const;
+
+    /// Seit dem letzten Aufruf fertig gewordene Spektrogramm-Spalten
+    QVector<QVector<double>> takeSpectrogramColumns(double *binHz = nullptr);
+
+    /// Treffer/Fehlschläge des gemeinsamen Periodogramm-Caches
+    SpectralCache::Stats cacheStats() const { return m_cache.stats(); }
+
+    /// Rechenzeit des letzten Jobs im Worker (µs)
+    double lastSpectrumJobUs() const { return m_lastSpectrumUs; }
+    double lastSpectrogramJobUs() const { return m_lastSpectrogramUs; }
+
+private:
+    enum JobType { SpectrumJob = 0, SpectrogramJob = 1, JobTypeCount };
+
+    // Zustand pro Job-Typ auf GUI-Seite
+    struct Slot {
+        bool    busy = false;
+        qint64  readFrom = 0;  // ältester Index, den der laufende Job liest
+        qint64  cursor = 0;    // erster noch nicht ausgewertete Verlaufsindex
+        quint64 version = 1;   // Einstellungs-/Reset-Stand
+    };
+
+    struct SpectrumWorker;
+    struct SpectrogramWorker;
+
+    struct SpectrogramResult {
+        QVector<QVector<double>> columns;
+        double  binHz   = 0.0;
+        quint64 version = 0;
+    };
+
+    int  pendingFrames(Slot &slot) const;
+    void startSpectrumJob();
+    void startSpectrogramJob();
+    void jobFinished(int type, double us);
+    int  minJobFrames() const;
+
+    const SampleHistory *m_history = nullptr;
+    int m_numChannels = 0;
+    SpectralCache m_cache;   // vor den Workern: die Schätzer zeigen darauf
+    QThreadPool m_pool;
+    Slot m_slots[JobTypeCount];
+
+    // Einstellungen (GUI-Seite, werden in jeden Job kopiert)
+    double                 m_sampleRate = 250.0;
+    WelchEstimator::Config m_welchConfig;
+    WelchEstimator::Config m_spectrogramConfig;
+    double                 m_zoomMaxHz  = 0.0;
+    double                 m_zoomStepHz = 0.0;
+    bool                   m_connectivity = false;
+    int                    m_spectrogramChannel = 0;
+
+    // Worker-Zustand (nur innerhalb der Jobs des jeweiligen Typs benutzt)
+    std::unique_ptr<SpectrumWorker>    m_spectrumWorker;
+    std::unique_ptr<SpectrogramWorker> m_spectrogramWorker;
+
+    // Veröffentlichte Ergebnisse (std::atomic_load/atomic_store)
+    std::shared_ptr<const SpectrumResult>    m_spectrum;
+    std::shared_ptr<const SpectrogramResult> m_spectrogram;
+
+    // Spalten, die die GUI noch nicht abgeholt hat
+    QVector<QVector<double>> m_columnQueue;
+    double m_columnBinHz = 0.0;
+
+    double m_lastSpectrumUs    = 0.0;
+    double m_lastSpectrogramUs = 0.0;
+};
+
+#endif // SPECTRALANALYZER_H
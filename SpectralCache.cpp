@@ -0,0 +1,66 @@
+#include "SpectralCache.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+
+SpectralCache::SpectralCache(int capacity)
+    : m_capacity(std::max(1, capacity)) {}
+
+void SpectralCache::setCapacity(int capacity) {
+  QMutexLocker lock(&m_mutex);
+  m_capacity = std::max(1, capacity);
+  evict();
+}
+
+SpectralCache::Spectrum SpectralCache::find(const Key &key) {
+  QMutexLocker lock(&m_mutex);
+  auto it = m_index.find(key);
+  if (it == m_index.end()) {
+    ++m_stats.misses;
+    return {};
+  }
+  ++m_stats.hits;
+  m_lru.splice(m_lru.begin(), m_lru, it.value());
+  return m_lru.front().second;
+}
+
+void SpectralCache::insert(const Key &key, Spectrum spectrum) {
+  QMutexLocker lock(&m_mutex);
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    // Parallel berechnet: neuer Wert, ans vordere Ende
+    it.value()->second = std::move(spectrum);
+    m_lru.splice(m_lru.begin(), m_lru, it.value());
+    return;
+  }
+  m_lru.emplace_front(key, std::move(spectrum));
+  m_index.insert(key, m_lru.begin());
+  evict();
+}
+
+void SpectralCache::evict() {
+  while (int(m_lru.size()) > m_capacity) {
+    m_index.remove(m_lru.back().first);
+    m_lru.pop_back();
+    ++m_stats.evictions;
+  }
+}
+
+void SpectralCache::clear() {
+  QMutexLocker lock(&m_mutex);
+  m_lru.clear();
+  m_index.clear();
+}
+
+SpectralCache::Stats SpectralCache::stats() const {
+  QMutexLocker lock(&m_mutex);
+  Stats s = m_stats;
+  s.entries = int(m_lru.size());
+  s.capacity = m_capacity;
+  return s;
+}
+
+void SpectralCache::resetStats() {
+  QMutexLocker lock(&m_mutex);
+  m_stats = Stats();
+}
@@ -0,0 +1,97 @@
+#ifndef SPECTRALCACHE_H
+#define SPECTRALCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+#include <QtGlobal>
+#include <list>
+#include <memory>
+
+/**
+ * Gemeinsamer Cache für Segment-Periodogramme.
+ *
+ * Schlüssel ist (Kanal, Verlaufsindex hinter dem Segmentende, Fensterspec).
+ * Alle WelchEstimator, die am selben Cache hängen und dasselbe Segment
+ * brauchen, transformieren es damit genau einmal; die Zahl der FFTs pro
+ * Sekunde hängt so nicht mehr davon ab, wie viele Spektralansichten
+ * dieselben Segmente auswerten. Verdrängt wird das am längsten nicht
+ * benutzte Periodogramm (LRU). Threadsicher.
+ */
+class SpectralCache
+{
+public:
+    struct Key {
+        int    channel    = 0;
+        qint64 endIndex   = 0;   // Verlaufsindex hinter dem letzten Sample
+        int    length     = 0;   // Segmentlänge
+        int    window     = 0;   // WelchEstimator::Window
+        double sampleRate = 0.0; // Skalierung (und neuer Verlauf bei fs-Wechsel)
+        int    bins       = 0;   // Frequenzraster (FFT oder Zoom)
+        double binHz      = 0.0;
+
+        bool operator==(const Key &o) const
+        {
+            return channel == o.channel && endIndex == o.endIndex &&
+                   length == o.length && window == o.window &&
+                   sampleRate == o.sampleRate && bins == o.bins &&
+                   binHz == o.binHz;
+        }
+    };
+
+    /// Einseitiges Periodogramm (µV²/Hz), Key::bins Werte
+    using Spectrum = std::shared_ptr<const QVector<double>>;
+
+    struct Stats {
+        quint64 hits      = 0;
+        quint64 misses    = 0;
+        quint64 evictions = 0;
+        int     entries   = 0;
+        int     capacity  = 0;
+
+        double hitRate() const
+        {
+            const quint64 n = hits + misses;
+            return n > 0 ? double(hits) / double(n) : 0.0;
+        }
+    };
+
+    explicit SpectralCache(int capacity = 256);
+    SpectralCache(const SpectralCache &) = delete;
+    SpectralCache &operator=(const SpectralCache &) = delete;
+
+    void setCapacity(int capacity);
+
+    /// Zählt Treffer/Fehlschlag; ein Treffer wird zum jüngsten Eintrag
+    Spectrum find(const Key &key);
+    void insert(const Key &key, Spectrum spectrum);
+
+    void clear();
+    Stats stats() const;
+    void resetStats();
+
+private:
+    using Entry = std::pair<Key, Spectrum>;
+
+    void evict();
+
+    mutable QMutex m_mutex;
+    int m_capacity = 256;
+    std::list<Entry> m_lru;                            // vorne = jüngster
+    QHash<Key, std::list<Entry>::iterator> m_index;
+    Stats m_stats;
+};
+
+inline size_t qHash(const SpectralCache::Key &key, size_t seed = 0) noexcept
+{
+    size_t h = seed ^ size_t(key.endIndex) * 0x9E3779B97F4A7C15ULL;
+    h ^= size_t(key.channel) + 0x9E3779B9U + (h << 6) + (h >> 2);
+    h ^= size_t(key.length) + 0x9E3779B9U + (h << 6) + (h >> 2);
+    h ^= size_t(key.window) + 0x9E3779B9U + (h << 6) + (h >> 2);
+    h ^= size_t(key.bins) + 0x9E3779B9U + (h << 6) + (h >> 2);
+    h ^= size_t(qRound64(key.sampleRate * 1000.0)) + 0x9E3779B9U + (h << 6) +
+         (h >> 2);
+    return h;
+}
+
+#endif // SPECTRALCACHE_H
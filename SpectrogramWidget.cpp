@@ -0,0 +1,151 @@
+#include "SpectrogramWidget.h"
+
+#include <QColor>
+#include <QPainter>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kAxisWidth = 34; // linker Rand für die Frequenzbeschriftung
+}
+
+SpectrogramWidget::SpectrogramWidget(QWidget *parent) : QWidget(parent) {
+  setAttribute(Qt::WA_OpaquePaintEvent);
+  setMinimumSize(200, 120);
+  buildLut();
+}
+
+void SpectrogramWidget::buildLut() {
+  // Dunkelblau -> Cyan -> Gelb -> Rot (ähnlich QCPColorGradient::gpJet)
+  const QColor stops[] = {QColor(0, 0, 80), QColor(0, 80, 255),
+                          QColor(0, 255, 255), QColor(255, 255, 0),
+                          QColor(255, 0, 0)};
+  const int segments = 4;
+
+  m_lut.resize(256);
+  for (int i = 0; i < 256; ++i) {
+    const double t = double(i) / 255.0 * segments;
+    const int s = std::min(int(t), segments - 1);
+    const double f = t - s;
+    const QColor &a = stops[s];
+    const QColor &b = stops[s + 1];
+    m_lut[i] = qRgb(int(a.red() + f * (b.red() - a.red())),
+                    int(a.green() + f * (b.green() - a.green())),
+                    int(a.blue() + f * (b.blue() - a.blue())));
+  }
+}
+
+void SpectrogramWidget::setHistoryColumns(int columns) {
+  columns = std::max(2, columns);
+  if (columns == m_columns)
+    return;
+  m_columns = columns;
+  allocate(m_image.height());
+}
+
+void SpectrogramWidget::setMaxFrequency(double hz) {
+  if (hz <= 0.0 || hz == m_maxHz)
+    return;
+  m_maxHz = hz;
+  update();
+}
+
+void SpectrogramWidget::setDbRange(double minDb, double maxDb) {
+  if (maxDb <= minDb)
+    return;
+  m_minDb = minDb;
+  m_maxDb = maxDb;
+}
+
+void SpectrogramWidget::clear() {
+  if (!m_image.isNull())
+    m_image.fill(m_lut[0]);
+  m_writeCol = 0;
+  m_filled = 0;
+  update();
+}
+
+void SpectrogramWidget::allocate(int rows) {
+  if (rows <= 0) {
+    m_image = QImage();
+  } else {
+    m_image = QImage(m_columns, rows, QImage::Format_RGB32);
+    m_image.fill(m_lut[0]);
+  }
+  m_writeCol = 0;
+  m_filled = 0;
+  update();
+}
+
+void SpectrogramWidget::appendColumn(const double *psd, int bins,
+                                     double binHz) {
+  if (!psd || bins <= 0 || binHz <= 0.0)
+    return;
+
+  // Neue Auflösung -> Bild neu anlegen (Historie passt nicht mehr)
+  if (bins != m_bins || binHz != m_binHz) {
+    m_bins = bins;
+    m_binHz = binHz;
+    allocate(bins);
+  }
+
+  const int rows = m_image.height();
+  const double scale = 255.0 / (m_maxDb - m_minDb);
+  const QRgb *lut = m_lut.constData();
+
+  // Eine Pixelspalte schreiben (Zeile 0 = höchste Frequenz)
+  uchar *bits = m_image.bits();
+  const auto stride = m_image.bytesPerLine();
+  for (int k = 0; k < rows; ++k) {
+    const double db = 10.0 * std::log10(psd[k] + 1e-12);
+    const int idx = qBound(0, int((db - m_minDb) * scale), 255);
+    auto *line = reinterpret_cast<QRgb *>(bits + (rows - 1 - k) * stride);
+    line[m_writeCol] = lut[idx];
+  }
+
+  if (++m_writeCol >= m_columns)
+    m_writeCol = 0;
+  m_filled = std::min(m_filled + 1, m_columns);
+  update();
+}
+
+void SpectrogramWidget::paintEvent(QPaintEvent *) {
+  QPainter p(this);
+  p.fillRect(rect(), palette().window());
+
+  const QRect plot = rect().adjusted(kAxisWidth, 2, -2, -2);
+  p.fillRect(plot, QColor::fromRgb(m_lut[0]));
+  if (m_image.isNull() || plot.width() <= 0 || plot.height() <= 0)
+    return;
+
+  // Sichtbarer Frequenzbereich als Quellzeilen (unten = 0 Hz)
+  const int rows = m_image.height();
+  const int visRows =
+      qBound(1, int(std::ceil(m_maxHz / m_binHz)) + 1, rows);
+  const int top = rows - visRows;
+
+  // Ring an der Schreibposition auftrennen: ältester Teil links
+  const double colW = double(plot.width()) / double(m_columns);
+  const int older = m_columns - m_writeCol; // Spalten [writeCol, columns)
+  const QRectF dstOld(plot.left(), plot.top(), older * colW, plot.height());
+  const QRectF dstNew(plot.left() + older * colW, plot.top(),
+                      m_writeCol * colW, plot.height());
+  p.drawImage(dstOld, m_image, QRectF(m_writeCol, top, older, visRows));
+  if (m_writeCol > 0)
+    p.drawImage(dstNew, m_image, QRectF(0, top, m_writeCol, visRows));
+
+  // Frequenzachse
+  p.setPen(palette().color(QPalette::WindowText));
+  QFont f = font();
+  f.setPixelSize(9);
+  p.setFont(f);
+  const double hzShown = visRows * m_binHz;
+  const double step = (hzShown > 60.0) ? 20.0 : (hzShown > 20.0 ? 10.0 : 5.0);
+  for (double hz = 0.0; hz <= hzShown; hz += step) {
+    const int y = plot.bottom() - int(hz / hzShown * plot.height());
+    p.drawLine(plot.left() - 3, y, plot.left(), y);
+    p.drawText(QRect(0, y - 6, kAxisWidth - 5, 12),
+               Qt::AlignRight | Qt::AlignVCenter, QString::number(hz));
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef SPECTROGRAMWIDGET_H
+#define SPECTROGRAMWIDGET_H
+
+#include <QImage>
+#include <QVector>
+#include <QWidget>
+
+/**
+ * Wasserfall-Spektrogramm (Zeit nach rechts, Frequenz nach oben).
+ *
+ * Spalten landen in einem ringförmigen QImage: appendColumn() schreibt
+ * genau eine Pixelspalte an die Schreibposition und schiebt diese weiter.
+ * Beim Zeichnen wird das Bild an der Schreibposition in zwei Teile
+ * geschnitten und versetzt ausgegeben – es wird nie die ganze Karte neu
+ * aufgebaut. Farben kommen aus einer 256er-Lookup-Tabelle (dB-Skala).
+ */
+class SpectrogramWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrogramWidget(QWidget *parent = nullptr);
+
+    /// Anzahl sichtbarer Spalten (Zeitachse)
+    void setHistoryColumns(int columns);
+    int historyColumns() const { return m_columns; }
+
+    /// Obere Grenze der Frequenzachse
+    void setMaxFrequency(double hz);
+    /// Farbskala in dB (10 log10 µV²/Hz)
+    void setDbRange(double minDb, double maxDb);
+
+    /// Neue Spalte aus einer einseitigen PSD (bins Werte, Abstand binHz)
+    void appendColumn(const double *psd, int bins, double binHz);
+
+    void clear();
+
+    QSize sizeHint() const override { return QSize(400, 200); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void allocate(int rows);
+    void buildLut();
+
+    QImage m_image;           // m_columns x Zeilen, Zeile 0 = höchste Frequenz
+    QVector<QRgb> m_lut;      // 256 Farben
+    int    m_columns  = 300;
+    int    m_writeCol = 0;    // nächste zu schreibende Spalte
+    int    m_filled   = 0;    // bereits beschriebene Spalten
+    double m_binHz    = 0.0;
+    int    m_bins     = 0;
+    double m_maxHz    = 100.0;
+    double m_minDb    = -20.0;
+    double m_maxDb    = 30.0;
+};
+
+#endif // SPECTROGRAMWIDGET_H
@@ -0,0 +1,242 @@
+#include "StreamingGraph.h"
+
+#include <algorithm>
+#include <cmath>
+
+StreamingGraph::StreamingGraph(QCPAxis *keyAxis, QCPAxis *valueAxis)
+    : QCPAbstractPlottable(keyAxis, valueAxis) {
+  // Live-Spuren werden nicht ausgewählt
+  setSelectable(QCP::stNone);
+}
+
+void StreamingGraph::configure(double dt, int capacity) {
+  capacity = std::max(2, capacity);
+  if (dt <= 0.0)
+    return;
+  if (capacity == m_capacity && std::abs(dt - m_dt) <= 1e-9 * dt)
+    return;
+  m_dt = dt;
+  m_capacity = capacity;
+  m_values.fill(0.0, capacity); // einzige Allokation
+  m_range.configure(capacity);
+  clear();
+}
+
+void StreamingGraph::clear() {
+  m_head = 0;
+  m_size = 0;
+  m_total = 0;
+  m_envelope.reset();
+  m_range.reset();
+}
+
+double StreamingGraph::value(int i) const {
+  return m_values[ringIndex(i)];
+}
+
+void StreamingGraph::addSamples(const double *values, int count, int stride,
+                                double startKey) {
+  if (count <= 0 || m_capacity == 0)
+    return;
+
+  // Implizite Keys gelten nur bei lückenloser Folge: Rücksprung oder
+  // Lücke -> neu beginnen
+  if (m_size > 0 && std::abs(startKey - (m_lastKey + m_dt)) > 0.5 * m_dt)
+    clear();
+
+  // Mehr als die Kapazität: nur die jüngsten Samples zählen
+  if (count > m_capacity) {
+    values += (count - m_capacity) * stride;
+    startKey += (count - m_capacity) * m_dt;
+    m_total += count - m_capacity;
+    count = m_capacity;
+  }
+
+  double *ring = m_values.data();
+  int pos = ringIndex(m_size < m_capacity ? m_size : 0);
+  for (int i = 0; i < count; ++i) {
+    ring[pos] = values[i * stride];
+    if (++pos >= m_capacity)
+      pos = 0;
+  }
+
+  // Überschriebene älteste Samples fallen heraus
+  const int overflow = std::max(0, m_size + count - m_capacity);
+  m_size = std::min(m_size + count, m_capacity);
+  m_head = (m_head + overflow) % m_capacity;
+  m_lastKey = startKey + (count - 1) * m_dt;
+
+  if (m_envelope.isConfigured())
+    m_envelope.append(values, count, stride, m_total);
+  m_range.append(values, count, stride);
+  m_total += count;
+}
+
+void StreamingGraph::prepareEnvelope(double samplesPerColumn, int columns) {
+  if (m_envelope.matches(samplesPerColumn, columns))
+    return;
+  // Zoom/Größenänderung: einmal aus dem Ring aufbauen (älteste zuerst)
+  m_envelope.configure(samplesPerColumn, columns);
+  const int head = std::min(m_size, m_capacity - m_head);
+  m_envelope.append(m_values.constData() + m_head, head, 1, sampleIndex(0));
+  m_envelope.append(m_values.constData(), m_size - head, 1,
+                    sampleIndex(head));
+}
+
+void StreamingGraph::indexRange(const QCPRange &range, int &begin,
+                                int &end) const {
+  const double first = firstKey();
+  begin = int(std::ceil((range.lower - first) / m_dt - 1e-9));
+  end = int(std::floor((range.upper - first) / m_dt + 1e-9)) + 1;
+  begin = qBound(0, begin, m_size);
+  end = qBound(begin, end, m_size);
+}
+
+QCPRange StreamingGraph::getKeyRange(bool &foundRange,
+                                     QCP::SignDomain inSignDomain) const {
+  foundRange = false;
+  if (m_size == 0)
+    return QCPRange();
+
+  QCPRange range(firstKey(), lastKey());
+  if (inSignDomain == QCP::sdPositive) {
+    if (range.upper <= 0.0)
+      return QCPRange();
+    range.lower = std::max(range.lower, m_dt);
+  } else if (inSignDomain == QCP::sdNegative) {
+    if (range.lower >= 0.0)
+      return QCPRange();
+    range.upper = std::min(range.upper, -m_dt);
+  }
+  foundRange = true;
+  return range;
+}
+
+QCPRange StreamingGraph::getValueRange(bool &foundRange,
+                                       QCP::SignDomain inSignDomain,
+                                       const QCPRange &inKeyRange) const {
+  foundRange = false;
+  int begin = 0, end = m_size;
+  if (inKeyRange != QCPRange())
+    indexRange(inKeyRange, begin, end);
+
+  // Jüngster Teilbereich (der Normalfall beim Mitlaufen): aus den
+  // mitgeführten Min/Max-Deques statt Scan
+  if (inSignDomain == QCP::sdBoth && end == m_size && begin < end) {
+    double lo = 0.0, hi = 0.0;
+    m_range.rangeOfLast(end - begin, lo, hi);
+    foundRange = true;
+    return QCPRange(lo, hi);
+  }
+
+  QCPRange range;
+  for (int i = begin; i < end; ++i) {
+    const double v = value(i);
+    if ((inSignDomain == QCP::sdPositive && v <= 0.0) ||
+        (inSignDomain == QCP::sdNegative && v >= 0.0))
+      continue;
+    if (!foundRange) {
+      range = QCPRange(v, v);
+      foundRange = true;
+    } else {
+      range.lower = std::min(range.lower, v);
+      range.upper = std::max(range.upper, v);
+    }
+  }
+  return range;
+}
+
+QCPRange StreamingGraph::robustValueRange(double quantile) const {
+  if (m_size == 0)
+    return QCPRange();
+  double lo = 0.0, hi = 0.0;
+  m_range.robustRange(lo, hi, quantile);
+  return QCPRange(lo, hi);
+}
+
+double StreamingGraph::selectTest(const QPointF &pos, bool onlySelectable,
+                                  QVariant *details) const {
+  if ((onlySelectable && mSelectable == QCP::stNone) || m_size == 0)
+    return -1;
+  if (!mKeyAxis || !mValueAxis)
+    return -1;
+  if (!mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()))
+    return -1;
+
+  // Nächstes Sample per Indexarithmetik statt Suche
+  double key = 0.0, v = 0.0;
+  pixelsToCoords(pos, key, v);
+  const int i =
+      qBound(0, int(std::lround((key - firstKey()) / m_dt)), m_size - 1);
+  if (details)
+    details->setValue(QCPDataSelection(QCPDataRange(i, i + 1)));
+  const QPointF p = coordsToPixels(firstKey() + i * m_dt, value(i));
+  return std::hypot(p.x() - pos.x(), p.y() - pos.y());
+}
+
+void StreamingGraph::draw(QCPPainter *painter) {
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis || m_size == 0 || keyAxis->range().size() <= 0)
+    return;
+
+  // Sichtbarer Bereich + je ein Sample darüber hinaus (Linie bis zum Rand)
+  int begin = 0, end = 0;
+  indexRange(keyAxis->range(), begin, end);
+  begin = std::max(0, begin - 1);
+  end = std::min(m_size, end + 1);
+  const int n = end - begin;
+  if (n < 1)
+    return;
+
+  const double first = firstKey();
+  const QCPRange range = keyAxis->range();
+  const double pixels = keyAxis->orientation() == Qt::Horizontal
+                            ? keyAxis->axisRect()->width()
+                            : keyAxis->axisRect()->height();
+  const int columns = std::max(1, int(pixels));
+  const double samplesPerColumn = range.size() / m_dt / columns;
+
+  m_lines.clear();
+  if (samplesPerColumn > 2.0 && keyAxis->scaleType() == QCPAxis::stLinear) {
+    // Mehr Samples als Pixel: Min/Max je Spalte aus der mitlaufenden
+    // Hüllkurve, O(Spalten) statt O(Samples); Spitzen bleiben sichtbar
+    // Spalten für den ganzen Ring: auch zurückgescrollte Bereiche liegen vor
+    prepareEnvelope(samplesPerColumn,
+                    int(std::ceil(m_capacity / samplesPerColumn)) + 1);
+    const qint64 colBegin = std::max(m_envelope.columnOf(sampleIndex(begin)),
+                                     m_envelope.firstColumn());
+    const qint64 colEnd = std::min(m_envelope.columnOf(sampleIndex(end - 1)),
+                                   m_envelope.lastColumn()) + 1;
+    const bool horizontal = keyAxis->orientation() == Qt::Horizontal;
+    const double keyOrigin = m_lastKey - (m_total - 1) * m_dt;
+    m_lines.reserve(int(2 * std::max<qint64>(0, colEnd - colBegin)));
+    for (qint64 j = colBegin; j < colEnd; ++j) {
+      const double start =
+          std::max(m_envelope.columnStart(j), double(sampleIndex(begin)));
+      const double px =
+          std::floor(keyAxis->coordToPixel(keyOrigin + start * m_dt));
+      const double lo = valueAxis->coordToPixel(m_envelope.low(j, 0));
+      const double hi = valueAxis->coordToPixel(m_envelope.high(j, 0));
+      m_lines.append(horizontal ? QPointF(px, lo) : QPointF(lo, px));
+      m_lines.append(horizontal ? QPointF(px, hi) : QPointF(hi, px));
+    }
+  } else {
+    m_lines.reserve(n);
+    for (int i = begin; i < end; ++i)
+      m_lines.append(coordsToPixels(first + i * m_dt, value(i)));
+  }
+
+  applyDefaultAntialiasingHint(painter);
+  painter->setPen(mPen);
+  painter->setBrush(Qt::NoBrush);
+  painter->drawPolyline(m_lines.constData(), m_lines.size());
+}
+
+void StreamingGraph::drawLegendIcon(QCPPainter *painter,
+                                    const QRectF &rect) const {
+  applyDefaultAntialiasingHint(painter);
+  painter->setPen(mPen);
+  painter->drawLine(QLineF(rect.left(), rect.center().y(), rect.right(),
+                           rect.center().y()));
+}
@@ -0,0 +1,99 @@
+#ifndef STREAMINGGRAPH_H
+#define STREAMINGGRAPH_H
+
+#include "MinMaxEnvelope.h"
+#include "SlidingRange.h"
+#include "qcustomplot.h"
+
+#include <QVector>
+
+/**
+ * QCustomPlot-Plottable für gleichmäßig abgetastete Live-Spuren.
+ *
+ * Statt QCPGraphDataContainer (Key + Value je Punkt, addData/removeBefore,
+ * wachsendes Prealloc und periodisches Umkopieren) liegt ein Ringpuffer
+ * fester Kapazität darunter. Keys werden nicht gespeichert, sondern
+ * ergeben sich aus dem jüngsten Key und dt:
+ *   key(i) = lastKey - (size - 1 - i) * dt,  i = 0 .. size-1 (älteste zuerst)
+ * Anhängen ist O(1) ohne Allokation, Bereichssuchen sind Indexarithmetik
+ * statt std::lower_bound. Alte Samples fallen von selbst heraus.
+ *
+ * Bei mehr Samples als Pixelspalten wird eine mitlaufende Min/Max-Hüllkurve
+ * je Spalte gezeichnet (MinMaxEnvelope); neu aufgebaut wird sie nur, wenn
+ * sich Achsenbereich oder Plotbreite ändern.
+ *
+ * Der Wertebereich über den Puffer wird beim Anhängen mitgeführt
+ * (SlidingRange): getValueRange() für jüngste Teilbereiche (z. B.
+ * rescaleValueAxis über das sichtbare Fenster) kostet O(log n) statt eines
+ * Scans, robustValueRange() liefert die Autoskala ohne Ausreißer.
+ */
+class StreamingGraph : public QCPAbstractPlottable
+{
+    Q_OBJECT
+
+public:
+    StreamingGraph(QCPAxis *keyAxis, QCPAxis *valueAxis);
+
+    /// Abstand dt und Kapazität (Samples); leert nur bei Änderung
+    void configure(double dt, int capacity);
+    double dt() const { return m_dt; }
+    int capacity() const { return m_capacity; }
+
+    /// count Werte (values[i * stride]), der erste beim Key startKey;
+    /// ein Key vor dem jüngsten leert den Puffer (neue Zeitbasis)
+    void addSamples(const double *values, int count, int stride,
+                    double startKey);
+    void clear();
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    double firstKey() const { return m_lastKey - (m_size - 1) * m_dt; }
+    double lastKey() const { return m_lastKey; }
+    /// i = 0 .. size-1, älteste zuerst
+    double value(int i) const;
+
+    /// Indexbereich [begin, end) der Samples mit Key in range
+    void indexRange(const QCPRange &range, int &begin, int &end) const;
+
+    /// Wertebereich über den Puffer ohne kurze Ausreißer (Quantil der
+    /// Block-Extrema, siehe SlidingRange); leer ohne Samples
+    QCPRange robustValueRange(double quantile = 0.95) const;
+
+    // QCPAbstractPlottable
+    double selectTest(const QPointF &pos, bool onlySelectable,
+                      QVariant *details = nullptr) const override;
+    QCPRange getKeyRange(bool &foundRange,
+                         QCP::SignDomain inSignDomain = QCP::sdBoth) const override;
+    QCPRange getValueRange(bool &foundRange,
+                           QCP::SignDomain inSignDomain = QCP::sdBoth,
+                           const QCPRange &inKeyRange = QCPRange()) const override;
+
+protected:
+    void draw(QCPPainter *painter) override;
+    void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const override;
+
+private:
+    int ringIndex(int i) const
+    {
+        const int pos = m_head + i;
+        return pos < m_capacity ? pos : pos - m_capacity;
+    }
+    /// Laufender Sample-Index von value(i)
+    qint64 sampleIndex(int i) const { return m_total - m_size + i; }
+    /// Hüllkurve passend zu Spaltenbreite/-zahl halten (ggf. aus dem Ring)
+    void prepareEnvelope(double samplesPerColumn, int columns);
+
+    QVector<double> m_values;   // Ring, Kapazität fest
+    int    m_capacity = 0;
+    int    m_head     = 0;      // Ringposition des ältesten Samples
+    int    m_size     = 0;
+    double m_dt       = 1.0;
+    double m_lastKey  = 0.0;
+    qint64 m_total    = 0;      // laufender Index hinter dem jüngsten Sample
+
+    MinMaxEnvelope m_envelope;  // Min/Max je Pixelspalte
+    SlidingRange   m_range;     // Min/Max über den Puffer, mitlaufend
+    QVector<QPointF> m_lines;   // Pixelpunkte, wiederverwendet
+};
+
+#endif // STREAMINGGRAPH_H
@@ -0,0 +1,401 @@
+#include "TopoHeatmap.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kLutSize = 1024;
+constexpr int kAlpha = 140;
+constexpr int kBlock = 64; // Pixel je Block, Akku auf dem Stack
+
+// Auflösungsstufen 2^(k/2) Pixel je Szeneneinheit
+constexpr int kMinStep = -4; // 1/4
+constexpr int kBaseStep = 0; // 1, einzige synchron gerechnete Stufe
+constexpr int kMaxStep = 4;  // 4
+constexpr double kStepTolerance = 0.15; // ~5 % Unterabtastung hinnehmen
+
+// Sphärische Splines nach Perrin et al. (1989)
+constexpr int kSplineOrder = 4;        // m
+constexpr int kLegendreTerms = 50;
+constexpr double kSplineLambda = 1e-8; // Regularisierung, klein gegen g(1)
+constexpr int kSplineTable = 4096;     // Stützstellen von g über cos ∈ [-1, 1]
+
+struct Vec3 {
+  double x, y, z;
+};
+
+double dot(const Vec3 &a, const Vec3 &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// P_0..P_terms(x): P_0 = 1, P_1 = x, n P_n = (2n-1) x P_{n-1} - (n-1) P_{n-2}
+void legendreSeries(double x, int terms, double *p) {
+  p[0] = 1.0;
+  if (terms >= 1)
+    p[1] = x;
+  for (int n = 2; n <= terms; ++n)
+    p[n] = ((2 * n - 1) * x * p[n - 1] - (n - 1) * p[n - 2]) / n;
+}
+
+// g(x) = 1/4π Σ_{n≥1} (2n+1) / (n(n+1))^m · P_n(x)
+double splineG(double x) {
+  double p[kLegendreTerms + 1];
+  legendreSeries(x, kLegendreTerms, p);
+  double sum = 0.0;
+  for (int n = 1; n <= kLegendreTerms; ++n)
+    sum += (2 * n + 1) / std::pow(double(n) * (n + 1), kSplineOrder) * p[n];
+  return sum / (4.0 * M_PI);
+}
+
+// g tabelliert, linear interpoliert (Fehler weit unter der Farbauflösung)
+double splineGTable(double x) {
+  static const QVector<double> table = [] {
+    QVector<double> t(kSplineTable + 1);
+    for (int k = 0; k <= kSplineTable; ++k)
+      t[k] = splineG(-1.0 + 2.0 * k / kSplineTable);
+    return t;
+  }();
+  const double pos = (qBound(-1.0, x, 1.0) + 1.0) * 0.5 * kSplineTable;
+  const int k = std::min(int(pos), kSplineTable - 1);
+  const double f = pos - k;
+  return table[k] + f * (table[k + 1] - table[k]);
+}
+
+// Gauß-Jordan mit Spaltenpivot, a (n x n, zeilenweise) wird zur Inversen
+bool invert(QVector<double> &a, int n) {
+  QVector<double> inv(n * n, 0.0);
+  for (int i = 0; i < n; ++i)
+    inv[i * n + i] = 1.0;
+  for (int c = 0; c < n; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < n; ++r)
+      if (std::abs(a[r * n + c]) > std::abs(a[pivot * n + c]))
+        pivot = r;
+    if (std::abs(a[pivot * n + c]) < 1e-300)
+      return false;
+    if (pivot != c) {
+      for (int k = 0; k < n; ++k) {
+        std::swap(a[c * n + k], a[pivot * n + k]);
+        std::swap(inv[c * n + k], inv[pivot * n + k]);
+      }
+    }
+    const double d = 1.0 / a[c * n + c];
+    for (int k = 0; k < n; ++k) {
+      a[c * n + k] *= d;
+      inv[c * n + k] *= d;
+    }
+    for (int r = 0; r < n; ++r) {
+      const double f = a[r * n + c];
+      if (r == c || f == 0.0)
+        continue;
+      for (int k = 0; k < n; ++k) {
+        a[r * n + k] -= f * a[c * n + k];
+        inv[r * n + k] -= f * inv[c * n + k];
+      }
+    }
+  }
+  a = inv;
+  return true;
+}
+
+// Rot-Grün-Verlauf wie bisher (setPixelColor mit QColor(r, g, 0, 140))
+const QRgb *colorTable() {
+  static const QVector<QRgb> lut = [] {
+    QVector<QRgb> t(kLutSize);
+    for (int k = 0; k < kLutSize; ++k) {
+      const double val = double(k) / (kLutSize - 1);
+      t[k] = qRgba(int(255 * val), int(255 * (1.0 - val)), 0, kAlpha);
+    }
+    return t;
+  }();
+  return lut.constData();
+}
+} // namespace
+
+QPointF TopoHeatmap::projectTenTwenty(double polarDeg, double azimuthDeg,
+                                      double headRadius) {
+  const double rho = polarDeg / 90.0;
+  const double phi = qDegreesToRadians(azimuthDeg);
+  return QPointF(headRadius * rho * std::sin(phi),
+                 -1.1 * headRadius * rho * std::cos(phi));
+}
+
+double TopoHeatmap::legendre(int n, double x) {
+  if (n <= 0)
+    return 1.0;
+  QVector<double> p(n + 1);
+  legendreSeries(x, n, p.data());
+  return p[n];
+}
+
+void TopoHeatmap::setLayout(const QVector<QPointF> &positions,
+                            double headRadius) {
+  m_positions = positions;
+  m_headRadius = headRadius;
+  invalidateLevels();
+}
+
+void TopoHeatmap::setSize(int width, int height) {
+  width = std::max(1, width);
+  height = std::max(1, height);
+  if (width == m_width && height == m_height)
+    return;
+  m_width = width;
+  m_height = height;
+  invalidateLevels();
+}
+
+void TopoHeatmap::setMethod(Method method) {
+  if (method == m_method)
+    return;
+  m_method = method;
+  invalidateLevels();
+}
+
+void TopoHeatmap::invalidateLevels() {
+  m_levels.clear();
+  ++m_geometry;
+  m_shownStep = kBaseStep;
+}
+
+void TopoHeatmap::setResolution(double pixelsPerUnit) {
+  // Kleinste Stufe mit mindestens der verlangten Dichte (5 % Toleranz)
+  const double steps =
+      2.0 * std::log2(std::max(pixelsPerUnit, 1e-6)) - kStepTolerance;
+  m_step = qBound(kMinStep, int(std::ceil(steps)), kMaxStep);
+  // Vorhandene Stufe sofort zeigen, sonst die bisherige bis addLevel()
+  if (findLevel(m_step))
+    m_shownStep = m_step;
+}
+
+double TopoHeatmap::resolution() const {
+  return std::pow(2.0, m_shownStep / 2.0);
+}
+
+TopoHeatmap::LevelSpec TopoHeatmap::levelSpec(int step) const {
+  LevelSpec spec;
+  spec.step = step;
+  spec.electrodes = int(std::min(m_activities.size(), m_positions.size()));
+  spec.positions = m_positions;
+  spec.headRadius = m_headRadius;
+  spec.width = m_width;
+  spec.height = m_height;
+  spec.method = m_method;
+  spec.geometry = m_geometry;
+  return spec;
+}
+
+TopoHeatmap::LevelSpec TopoHeatmap::pendingLevel() const {
+  return levelSpec(m_step);
+}
+
+TopoHeatmap::Level *TopoHeatmap::findLevel(int step) {
+  for (Level &level : m_levels)
+    if (level.step == step)
+      return &level;
+  return nullptr;
+}
+
+TopoHeatmap::Level TopoHeatmap::buildLevel(const LevelSpec &spec) {
+  Level level;
+  level.step = spec.step;
+  level.geometry = spec.geometry;
+  buildWeights(level, spec);
+  return level;
+}
+
+bool TopoHeatmap::addLevel(Level level) {
+  if (level.geometry != m_geometry)
+    return false;
+  const int step = level.step;
+  if (Level *old = findLevel(step)) {
+    *old = level;
+  } else {
+    if (m_levels.size() >= kMaxLevels) {
+      auto oldest = m_levels.end();
+      for (auto it = m_levels.begin(); it != m_levels.end(); ++it)
+        if (it->step != m_shownStep &&
+            (oldest == m_levels.end() || it->lastUsed < oldest->lastUsed))
+          oldest = it;
+      m_levels.erase(oldest);
+    }
+    m_levels.append(level);
+  }
+  findLevel(step)->lastUsed = ++m_useCounter;
+  if (step == m_step)
+    m_shownStep = step;
+  return true;
+}
+
+TopoHeatmap::Level &TopoHeatmap::shownLevel() {
+  Level *level = findLevel(m_shownStep);
+  if (!level) {
+    // Keine Stufe (erstes Bild, neue Geometrie): nur die Grundstufe
+    // synchron, die angefragte bleibt ausstehend (levelPending())
+    addLevel(buildLevel(levelSpec(m_shownStep)));
+    level = findLevel(m_shownStep);
+  }
+  level->lastUsed = ++m_useCounter;
+  return *level;
+}
+
+void TopoHeatmap::buildWeights(Level &level, const LevelSpec &spec) {
+  const double scale = std::pow(2.0, level.step / 2.0);
+  const int width = std::max(1, qRound(spec.width * scale));
+  const int height = std::max(1, qRound(spec.height * scale));
+  const int electrodes = spec.electrodes;
+  level.electrodes = electrodes;
+  level.image = QImage(width, height, QImage::Format_ARGB32);
+  level.image.fill(Qt::transparent);
+
+  // Maske: Pixel im Kopfoval; Bildmitte entspricht Szene (0, 0)
+  const double offsetX = 0.5 * width;
+  const double offsetY = 0.5 * height;
+  const double rx2 = spec.headRadius * spec.headRadius;
+  const double ry2 = (1.1 * spec.headRadius) * (1.1 * spec.headRadius);
+  const int stride = level.image.bytesPerLine() / int(sizeof(QRgb));
+  level.pixels.clear();
+  for (int y = 0; y < height; ++y) {
+    const double py = (double(y) - offsetY) / scale;
+    for (int x = 0; x < width; ++x) {
+      const double px = (double(x) - offsetX) / scale;
+      if ((px * px) / rx2 + (py * py) / ry2 <= 1.0)
+        level.pixels.append(y * stride + x);
+    }
+  }
+
+  // Gewichte elektrodenweise, auf ganze Blöcke aufgefüllt (Gewicht 0)
+  const int P = level.pixels.size();
+  level.stride = (P + kBlock - 1) / kBlock * kBlock;
+  level.weights.fill(0.0f, electrodes * level.stride);
+  if (electrodes == 0)
+    return;
+  QVector<QPointF> scene(P);
+  for (int p = 0; p < P; ++p)
+    scene[p] = QPointF((double(level.pixels[p] % stride) - offsetX) / scale,
+                       (double(level.pixels[p] / stride) - offsetY) / scale);
+  if (spec.method == InverseDistance ||
+      !buildSplineWeights(level, spec, scene))
+    buildInverseDistanceWeights(level, spec, scene);
+}
+
+void TopoHeatmap::buildInverseDistanceWeights(Level &level,
+                                              const LevelSpec &spec,
+                                              const QVector<QPointF> &scene) {
+  // Normierte IDW-Gewichte (d + 0.01)⁻²
+  const int electrodes = spec.electrodes;
+  QVector<double> w(electrodes);
+  for (int p = 0; p < scene.size(); ++p) {
+    double sumW = 0.0;
+    for (int e = 0; e < electrodes; ++e) {
+      const double dx = scene[p].x() - spec.positions[e].x();
+      const double dy = scene[p].y() - spec.positions[e].y();
+      const double d = qSqrt(dx * dx + dy * dy) + 0.01;
+      w[e] = 1.0 / (d * d);
+      sumW += w[e];
+    }
+    for (int e = 0; e < electrodes; ++e)
+      level.weights[e * level.stride + p] = float(w[e] / sumW);
+  }
+}
+
+bool TopoHeatmap::buildSplineWeights(Level &level, const LevelSpec &spec,
+                                     const QVector<QPointF> &scene) {
+  // Szene -> Einheitskugel (Umkehrung von projectTenTwenty)
+  const double headRadius = spec.headRadius;
+  auto toSphere = [headRadius](const QPointF &pt) {
+    const double u = pt.x() / headRadius;
+    const double v = -pt.y() / (1.1 * headRadius);
+    const double rho = std::sqrt(u * u + v * v);
+    if (rho < 1e-12)
+      return Vec3{0.0, 0.0, 1.0};
+    const double theta = rho * M_PI / 2.0;
+    const double s = std::sin(theta) / rho;
+    return Vec3{u * s, v * s, std::cos(theta)};
+  };
+  const int electrodes = spec.electrodes;
+  QVector<Vec3> el(electrodes);
+  for (int e = 0; e < electrodes; ++e)
+    el[e] = toSphere(spec.positions[e]);
+
+  // [G + λI  1; 1ᵀ  0] einmal je Layout invertieren
+  const int n = electrodes + 1;
+  QVector<double> m(n * n, 0.0);
+  for (int i = 0; i < electrodes; ++i) {
+    for (int j = 0; j < electrodes; ++j)
+      m[i * n + j] = splineG(dot(el[i], el[j]));
+    m[i * n + i] += kSplineLambda;
+    m[i * n + electrodes] = m[electrodes * n + i] = 1.0;
+  }
+  if (!invert(m, n))
+    return false;
+
+  // Wert am Pixel = [g(p, e_1..e_E), 1] · M⁻¹ · [a; 0], also Gewicht je
+  // Elektrode = Zeile mal Spalte e der Inversen
+  QVector<double> g(electrodes);
+  for (int p = 0; p < scene.size(); ++p) {
+    const Vec3 s = toSphere(scene[p]);
+    for (int k = 0; k < electrodes; ++k)
+      g[k] = splineGTable(dot(s, el[k]));
+    for (int e = 0; e < electrodes; ++e) {
+      double w = m[electrodes * n + e];
+      for (int k = 0; k < electrodes; ++k)
+        w += g[k] * m[k * n + e];
+      level.weights[e * level.stride + p] = float(w);
+    }
+  }
+  return true;
+}
+
+const QImage &TopoHeatmap::render(const QVector<double> &activities) {
+  // Andere Elektrodenzahl: alle Gewichte ungültig, wie bei neuem Layout
+  const bool electrodesChanged =
+      std::min(activities.size(), m_positions.size()) !=
+      std::min(m_activities.size(), m_positions.size());
+  m_activities = activities;
+  if (electrodesChanged)
+    invalidateLevels();
+  ++m_version;
+  Level &level = shownLevel();
+  fill(level);
+  return level.image;
+}
+
+const QImage &TopoHeatmap::image() {
+  Level &level = shownLevel();
+  if (level.version != m_version)
+    fill(level);
+  return level.image;
+}
+
+int TopoHeatmap::pixelCount() {
+  return shownLevel().pixels.size();
+}
+
+void TopoHeatmap::fill(Level &level) {
+  const int electrodes = level.electrodes; // = Aktivitäten, siehe render()
+  level.version = m_version;
+
+  // v = W · a blockweise; der Akku auf dem Stack kann nicht mit den
+  // Gewichten überlappen, die Schleife vektorisiert so auch ohne -O3
+  QRgb *bits = reinterpret_cast<QRgb *>(level.image.bits());
+  const int *pixels = level.pixels.constData();
+  const QRgb *lut = colorTable();
+  const int P = level.pixels.size();
+  for (int b = 0; b < P; b += kBlock) {
+    float acc[kBlock] = {};
+    for (int e = 0; e < electrodes; ++e) {
+      const float a = float(m_activities[e]);
+      const float *w = level.weights.constData() + e * level.stride + b;
+      for (int i = 0; i < kBlock; ++i)
+        acc[i] += w[i] * a;
+    }
+    // Farbtabelle direkt in den Bildspeicher
+    const int n = std::min(kBlock, P - b);
+    for (int i = 0; i < n; ++i) {
+      const float v = qBound(0.0f, acc[i], 1.0f);
+      bits[pixels[b + i]] = lut[int(v * (kLutSize - 1) + 0.5f)];
+    }
+  }
+}
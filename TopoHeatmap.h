@@ -0,0 +1,147 @@
+#ifndef TOPOHEATMAP_H
+#define TOPOHEATMAP_H
+
+#include <QImage>
+#include <QPointF>
+#include <QVector>
+
+/**
+ * Heatmap der Elektrodenaktivität über dem Kopfoval (ElectrodeMap).
+ *
+ * Die Geometrie ändert sich nur mit dem Elektrodenlayout. Maske (Pixel im
+ * Kopfoval) und Interpolationsgewichte w_e(p) werden deshalb einmal je
+ * Layout und Auflösung berechnet; ein Update ist dann nur
+ *   v(p) = Σ_e w_e(p) · a_e
+ * über die Pixel im Oval (Gewichte elektrodenweise hintereinander, damit
+ * die innere Schleife vektorisiert), gefolgt von einer Farbtabelle, die
+ * direkt in den Bildspeicher schreibt. Pixel außerhalb bleiben transparent.
+ *
+ * SphericalSpline (Standard): sphärische Splines nach Perrin et al. (1989),
+ * m = 4, 50 Legendre-Terme. Szenenpunkte liegen azimutal-äquidistant
+ * projiziert auf der Kopfkugel (Vertex in der Mitte, Äquator auf dem
+ * Oval, siehe projectTenTwenty). Die Systemmatrix [G 1; 1ᵀ 0] wird je Layout
+ * einmal invertiert und mit g(Pixel, Elektrode) zu den Gewichten
+ * multipliziert; das Update bleibt dasselbe Matrix-Vektor-Produkt.
+ * InverseDistance: bisherige Gewichte (d + 0.01)⁻², normiert.
+ *
+ * Auflösung: setResolution() wählt die Stufe 2^(k/2) Pixel je
+ * Szeneneinheit, die mindestens die angefragte Dichte hat (1/4 bis 4).
+ * Die letzten kMaxLevels Stufen bleiben samt Gewichten erhalten und werden
+ * beim Wechsel nur dann neu gefüllt, wenn seitdem neue Aktivitäten kamen.
+ * Fehlt die angefragte Stufe, bleibt die bisherige sichtbar
+ * (levelPending()); buildLevel() rechnet die neue aus einer Kopie der
+ * Eingaben, also auch außerhalb des GUI-Threads, addLevel() übernimmt sie.
+ * Ohne jede Stufe (erstes Bild, neues Layout, andere Elektrodenzahl) wird
+ * nur die Grundstufe (1 Pixel je Einheit) synchron gerechnet.
+ */
+class TopoHeatmap
+{
+public:
+    enum Method { SphericalSpline, InverseDistance };
+
+    TopoHeatmap() = default;
+
+    /// 10-20-Position (Polarwinkel vom Vertex, Azimut von der Nase, rechts
+    /// positiv, beides in Grad) in Szenenkoordinaten; 90° liegt auf dem Oval
+    static QPointF projectTenTwenty(double polarDeg, double azimuthDeg,
+                                    double headRadius);
+
+    /// Legendre-Polynom P_n(x) der Spline-Kerne (Rekursion wie intern)
+    static double legendre(int n, double x);
+
+    /// Elektroden in Szenenkoordinaten; Kopfoval um (0,0) mit Radius
+    /// headRadius und 1.1-facher Höhe
+    void setLayout(const QVector<QPointF> &positions, double headRadius);
+    /// Fläche in Szeneneinheiten; Bildmitte = Szene (0,0)
+    void setSize(int width, int height);
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    void setMethod(Method method);
+    Method method() const { return m_method; }
+
+    /// Benötigte Pixel je Szeneneinheit (Ansichtsskalierung mal
+    /// Geräte-Pixelverhältnis); wechselt nur beim Überschreiten einer Stufe
+    void setResolution(double pixelsPerUnit);
+    /// Pixel je Szeneneinheit der gezeigten Stufe
+    double resolution() const;
+
+    /// Eingaben einer Stufe; buildLevel() braucht nichts weiter vom Objekt
+    struct LevelSpec {
+        int    step = 0;
+        int    electrodes = 0;
+        QVector<QPointF> positions;
+        double headRadius = 80.0;
+        int    width = 0;
+        int    height = 0;
+        Method method = SphericalSpline;
+        quint64 geometry = 0;      // Stand von Layout, Größe und Methode
+    };
+
+    struct Level {
+        int    step = 0;           // Auflösung 2^(step/2)
+        int    electrodes = -1;    // Stand der Gewichte, -1 = neu berechnen
+        quint64 geometry = 0;
+        QVector<int>   pixels;     // Offsets der Pixel im Oval (in QRgb)
+        int    stride = 0;         // Pixel je Elektrode, auf Blöcke aufgefüllt
+        QVector<float> weights;    // [electrode * stride + p]
+        QImage image;
+        quint64 version = 0;       // gezeichneter Stand von m_activities
+        quint64 lastUsed = 0;
+    };
+
+    /// Angefragte Stufe fehlt noch, gezeigt wird bis dahin die bisherige
+    bool levelPending() const { return m_step != m_shownStep; }
+    /// Eingaben der angefragten Stufe (Kopie, für einen Pool-Job)
+    LevelSpec pendingLevel() const;
+    /// Maske und Gewichte einer Stufe; reentrant
+    static Level buildLevel(const LevelSpec &spec);
+    /// Gerechnete Stufe übernehmen (verdrängt die älteste, nie die
+    /// gezeigte) und zeigen, falls sie angefragt ist; false, wenn sich
+    /// Layout, Größe oder Methode inzwischen geändert haben
+    bool addLevel(Level level);
+
+    /// Aktivitäten 0..1 je Elektrode (ggf. weniger als Positionen); zeichnet
+    /// die gezeigte Stufe
+    const QImage &render(const QVector<double> &activities);
+    /// Bild der gezeigten Stufe (deckt width() x height() Szeneneinheiten)
+    const QImage &image();
+
+    /// Pixel im Kopfoval der gezeigten Stufe
+    int pixelCount();
+
+private:
+    static constexpr int kMaxLevels = 3;
+
+    LevelSpec levelSpec(int step) const;
+    Level *findLevel(int step);
+    /// Gezeigte Stufe; ohne jede Stufe wird hier die Grundstufe gerechnet
+    Level &shownLevel();
+    /// Alle Stufen verwerfen (Layout, Größe oder Methode geändert)
+    void invalidateLevels();
+    static void buildWeights(Level &level, const LevelSpec &spec);
+    static void buildInverseDistanceWeights(Level &level,
+                                            const LevelSpec &spec,
+                                            const QVector<QPointF> &scene);
+    /// false, wenn die Systemmatrix singulär ist (z. B. doppelte Positionen)
+    static bool buildSplineWeights(Level &level, const LevelSpec &spec,
+                                   const QVector<QPointF> &scene);
+    /// Stufe auf den Stand von m_activities bringen
+    void fill(Level &level);
+
+    QVector<QPointF> m_positions;
+    double m_headRadius = 80.0;
+    int    m_width  = 300;
+    int    m_height = 300;
+    Method m_method = SphericalSpline;
+    quint64 m_geometry = 0;
+
+    QVector<Level> m_levels;       // zuletzt benutzte Stufen
+    int     m_step = 0;            // angefragte Stufe
+    int     m_shownStep = 0;       // gezeigte (vorhandene) Stufe
+    quint64 m_useCounter = 0;
+    QVector<double> m_activities;  // zuletzt übergeben
+    quint64 m_version = 0;
+};
+
+#endif // TOPOHEATMAP_H
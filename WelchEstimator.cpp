@@ -0,0 +1,326 @@
+#include "WelchEstimator.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Laufende Summe regelmäßig neu aufaddieren (Rundungsdrift)
+constexpr int kResumInterval = 64;
+} // namespace
+
+WelchEstimator::WelchEstimator(double sampleRate)
+    : WelchEstimator(sampleRate, Config()) {}
+
+WelchEstimator::WelchEstimator(double sampleRate, const Config &config,
+                               int channels)
+    : m_config(config), m_sampleRate(sampleRate),
+      m_channels(std::max(1, channels)) {
+  configure();
+}
+
+void WelchEstimator::setConfig(const Config &config) {
+  m_config = config;
+  configure();
+}
+
+void WelchEstimator::setSampleRate(double fs) {
+  if (fs <= 0.0 || fs == m_sampleRate)
+    return;
+  m_sampleRate = fs;
+  configure();
+}
+
+void WelchEstimator::configure() {
+  const int L =
+      (m_config.segmentSeconds > 0.0 || m_config.resolutionHz > 0.0)
+          ? FftPlan::sizeForWindow(m_sampleRate, m_config.segmentSeconds,
+                                   m_config.resolutionHz)
+          : FftPlan::goodSize(m_config.segmentLength);
+  m_config.segmentLength = L;
+  m_config.overlap = qBound(0.0, m_config.overlap, 0.95);
+  m_config.averages = std::max(1, m_config.averages);
+
+  m_hop = std::max(1, qRound(L * (1.0 - m_config.overlap)));
+  m_plan = FftPlan::forSize(L);
+  m_ws.ensure(L, m_channels);
+
+  m_chirp.reset();
+  m_bins = L / 2 + 1;
+  m_binHz = m_sampleRate / double(L);
+  if (m_config.zoomMaxHz > 0.0 && m_config.zoomStepHz > 0.0) {
+    const double maxHz = std::min(m_config.zoomMaxHz, 0.5 * m_sampleRate);
+    m_bins = int(std::floor(maxHz / m_config.zoomStepHz + 1e-9)) + 1;
+    m_binHz = m_config.zoomStepHz;
+    m_chirp = ChirpZ::symmetric(L, m_sampleRate, m_binHz, m_bins);
+  }
+  m_segment.resize(L * m_channels);
+  m_mean.resize(m_channels);
+
+  // Fenster einmal pro Konfiguration
+  if (m_config.window == Window::Hann) {
+    m_window = *FftPlan::hannWindow(L);
+  } else {
+    m_window.resize(L);
+    for (int i = 0; i < L; ++i) {
+      m_window[i] = (m_config.window == Window::Hamming)
+                        ? 0.54 - 0.46 * std::cos(2.0 * M_PI * i / (L - 1))
+                        : 1.0;
+    }
+  }
+
+  double sumSq = 0.0;
+  for (double w : m_window)
+    sumSq += w * w;
+  m_scale = (sumSq > 0.0 && m_sampleRate > 0.0)
+                ? 1.0 / (m_sampleRate * sumSq)
+                : 1.0;
+
+  const int values = m_channels * bins();
+  m_spectrumRe.resize(hasSpectra() ? values : 0);
+  m_spectrumIm.resize(hasSpectra() ? values : 0);
+  m_ring.resize(L * m_channels);
+  m_psd.resize(values);
+  m_lastPeriodogram.resize(values);
+  m_sum.resize(values);
+  if (m_config.averaging == Averaging::Running)
+    m_history.resize(m_config.averages * values);
+  else
+    m_history.clear();
+
+  reset();
+}
+
+void WelchEstimator::reset() {
+  m_ring.fill(0.0);
+  m_psd.fill(0.0);
+  m_lastPeriodogram.fill(0.0);
+  m_sum.fill(0.0);
+  m_history.fill(0.0);
+  m_writePos = 0;
+  m_filled = 0;
+  m_historyPos = 0;
+  m_averaged = 0;
+  m_sinceResum = 0;
+  m_generation = 0; // Verbraucher setzen ihren Stand beim Reset ebenfalls auf 0
+}
+
+QVector<double> WelchEstimator::psd(int channel) const {
+  if (m_channels == 1)
+    return m_psd; // implizit geteilt, keine Kopie
+  return m_psd.mid(channel * bins(), bins());
+}
+
+QVector<double> WelchEstimator::lastPeriodogram(int channel) const {
+  if (m_channels == 1)
+    return m_lastPeriodogram;
+  return m_lastPeriodogram.mid(channel * bins(), bins());
+}
+
+int WelchEstimator::append(const double *samples, int count, int stride) {
+  const int C = m_channels;
+  int segments = 0;
+  for (int i = 0; i < count; ++i) {
+    const double *frame = samples + i * stride;
+    double *slot = m_ring.data() + m_writePos * C;
+    for (int c = 0; c < C; ++c)
+      slot[c] = frame[c];
+    segments += advance();
+  }
+  return segments;
+}
+
+int WelchEstimator::append(const double *const *channels, int count) {
+  const int C = m_channels;
+  int segments = 0;
+  for (int i = 0; i < count; ++i) {
+    double *slot = m_ring.data() + m_writePos * C;
+    for (int c = 0; c < C; ++c)
+      slot[c] = channels[c][i];
+    segments += advance();
+  }
+  return segments;
+}
+
+bool WelchEstimator::advance() {
+  const int L = m_config.segmentLength;
+  if (++m_writePos >= L)
+    m_writePos = 0;
+  if (m_filled < L)
+    ++m_filled;
+  ++m_streamIndex;
+
+  // Segmentraster am laufenden Index ausrichten (gleiche Segmente wie
+  // andere Schätzer mit derselben Spec)
+  if (m_filled < L || m_streamIndex % m_hop != 0)
+    return false;
+  processSegment();
+  return true;
+}
+
+void WelchEstimator::setKeepSpectra(bool keep) {
+  if (keep == m_keepSpectra)
+    return;
+  m_keepSpectra = keep;
+  const int values = hasSpectra() ? m_channels * bins() : 0;
+  m_spectrumRe.fill(0.0, values);
+  m_spectrumIm.fill(0.0, values);
+}
+
+void WelchEstimator::setCache(SpectralCache *cache, int firstChannel) {
+  m_cache = cache;
+  m_firstChannel = firstChannel;
+}
+
+SpectralCache::Key WelchEstimator::cacheKey(int channel) const {
+  SpectralCache::Key key;
+  key.channel = m_firstChannel + channel;
+  key.endIndex = m_streamIndex;
+  key.length = m_config.segmentLength;
+  key.window = int(m_config.window);
+  key.sampleRate = m_sampleRate;
+  key.bins = m_bins;
+  key.binHz = m_binHz;
+  return key;
+}
+
+bool WelchEstimator::fetchCached(double *periodogram) {
+  // Alle Kanäle nachschlagen (Zähler je Kanal); fehlt einer, rechnet die
+  // Batch-FFT ohnehin alle
+  const int K = bins();
+  bool complete = true;
+  for (int c = 0; c < m_channels; ++c) {
+    const SpectralCache::Spectrum hit = m_cache->find(cacheKey(c));
+    if (hit && hit->size() == K)
+      std::copy(hit->constBegin(), hit->constEnd(), periodogram + c * K);
+    else
+      complete = false;
+  }
+  return complete;
+}
+
+void WelchEstimator::storeCached(const double *periodogram) {
+  const int K = bins();
+  for (int c = 0; c < m_channels; ++c) {
+    auto spectrum = std::make_shared<QVector<double>>(K);
+    std::copy(periodogram + c * K, periodogram + (c + 1) * K,
+              spectrum->begin());
+    m_cache->insert(cacheKey(c), std::move(spectrum));
+  }
+}
+
+void WelchEstimator::processSegment() {
+  double *p = m_lastPeriodogram.data();
+
+  // Mit Spektren muss das Segment ohnehin transformiert werden
+  if (!m_cache || hasSpectra() || !fetchCached(p)) {
+    computePeriodogram(p);
+    if (m_cache)
+      storeCached(p);
+  }
+  accumulate(p);
+  ++m_generation;
+}
+
+void WelchEstimator::computePeriodogram(double *p) {
+  const int L = m_config.segmentLength;
+  const int C = m_channels;
+  const int K = bins();
+
+  // Mittelwert je Kanal
+  const double *ring = m_ring.constData();
+  double *mu = m_mean.data();
+  std::fill(mu, mu + C, 0.0);
+  for (int i = 0; i < L; ++i)
+    for (int c = 0; c < C; ++c)
+      mu[c] += ring[i * C + c];
+  for (int c = 0; c < C; ++c)
+    mu[c] /= double(L);
+
+  // Ringpuffer ab dem ältesten Frame ausrollen (zwei zusammenhängende Teile)
+  double *seg = m_segment.data();
+  const double *w = m_window.constData();
+  for (int i = 0; i < L; ++i) {
+    const double *src = ring + ((m_writePos + i) % L) * C;
+    double *dst = seg + i * C;
+    for (int c = 0; c < C; ++c)
+      dst[c] = (src[c] - mu[c]) * w[i];
+  }
+
+  if (m_chirp) {
+    // Zoom: nur das Raster 0 .. zoomMaxHz, je zwei Kanäle eine Chirp-Z
+    for (int c = 0; c < C; c += 2) {
+      const bool pair = c + 1 < C;
+      m_chirp->powerPair(seg + c, pair ? seg + c + 1 : nullptr, C, m_czWs,
+                         p + c * K, pair ? p + (c + 1) * K : nullptr);
+    }
+
+    const double nyquist = 0.5 * m_sampleRate;
+    for (int k = 0; k < K; ++k) {
+      const double f = k * m_binHz;
+      const double s =
+          (k == 0 || f >= nyquist - 1e-9) ? m_scale : 2.0 * m_scale;
+      for (int c = 0; c < C; ++c)
+        p[c * K + k] *= s;
+    }
+    return;
+  }
+
+  if (hasSpectra()) {
+    // Komplexe Bins behalten, |X|^2 daraus
+    double *re = m_spectrumRe.data();
+    double *im = m_spectrumIm.data();
+    m_plan->forwardBatch(seg, C, m_ws, re, im);
+    for (int i = 0; i < C * K; ++i)
+      p[i] = re[i] * re[i] + im[i] * im[i];
+  } else {
+    // Alle Kanäle in einem Aufruf -> |X|^2 je Kanal
+    m_plan->forwardPowerBatch(seg, C, m_ws, p);
+  }
+
+  // Einseitiges Periodogramm
+  for (int c = 0; c < C; ++c) {
+    double *pc = p + c * K;
+    for (int k = 0; k < K; ++k)
+      pc[k] *= (k == 0 || k == K - 1) ? m_scale : 2.0 * m_scale;
+  }
+}
+
+void WelchEstimator::accumulate(const double *p) {
+  const int V = m_channels * bins(); // alle Kanäle gemeinsam mitteln
+  const int N = m_config.averages;
+  if (m_config.averaging == Averaging::Exponential) {
+    if (m_averaged == 0) {
+      std::copy(p, p + V, m_psd.begin());
+    } else {
+      const double alpha = 1.0 / double(N);
+      for (int k = 0; k < V; ++k)
+        m_psd[k] += alpha * (p[k] - m_psd[k]);
+    }
+    m_averaged = std::min(m_averaged + 1, N);
+  } else {
+    double *slot = m_history.data() + m_historyPos * V;
+    const bool full = (m_averaged == N);
+    for (int k = 0; k < V; ++k) {
+      m_sum[k] += p[k] - (full ? slot[k] : 0.0);
+      slot[k] = p[k];
+    }
+    m_historyPos = (m_historyPos + 1) % N;
+    if (!full)
+      ++m_averaged;
+
+    if (++m_sinceResum >= kResumInterval) {
+      m_sinceResum = 0;
+      m_sum.fill(0.0);
+      for (int s = 0; s < m_averaged; ++s) {
+        const double *h = m_history.constData() + s * V;
+        for (int k = 0; k < V; ++k)
+          m_sum[k] += h[k];
+      }
+    }
+
+    const double inv = 1.0 / double(m_averaged);
+    for (int k = 0; k < V; ++k)
+      m_psd[k] = std::max(0.0, m_sum[k] * inv);
+  }
+}
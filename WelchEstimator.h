@@ -0,0 +1,164 @@
+#ifndef WELCHESTIMATOR_H
+#define WELCHESTIMATOR_H
+
+#include "ChirpZ.h"
+#include "FftPlan.h"
+#include "SpectralCache.h"
+
+#include <QVector>
+#include <memory>
+
+/**
+ * Streaming-Welch-PSD für einen oder mehrere Kanäle.
+ *
+ * Eingehende Samples laufen in einen Ringpuffer der Segmentlänge. Sobald
+ * ein Hop (= Segmentlänge * (1 - Overlap)) neuer Samples da ist, wird genau
+ * ein Segment gefenstert und transformiert, das Periodogramm geht in einen
+ * laufenden (Rechteck über die letzten N) oder exponentiellen Mittelwert.
+ * Die Arbeit pro Block ist damit klein und gleichmäßig verteilt, und psd()
+ * liefert jederzeit ein fertiges Spektrum.
+ *
+ * Mehrere Kanäle teilen sich Ringpuffer (interleavt) und Segmenttakt; ihre
+ * Segmente gehen gemeinsam durch FftPlan::forwardPowerBatch.
+ *
+ * Segmente enden immer auf Vielfachen des Hops im laufenden Sample-Index
+ * (setStreamIndex). Schätzer mit gleicher Fensterspec rechnen damit
+ * dieselben Segmente und teilen sich die Periodogramme über einen
+ * SpectralCache.
+ */
+class WelchEstimator
+{
+public:
+    enum class Window { Hann, Hamming, Rectangular };
+    enum class Averaging { Running, Exponential };
+
+    struct Config {
+        int       segmentLength = 1024;  // Samples, wird auf FftPlan::goodSize gerundet
+        double    overlap       = 0.5;   // 0 .. 0.95
+        int       averages      = 8;     // Tiefe (Running) bzw. 1/alpha (Exponential)
+        Window    window        = Window::Hann;
+        Averaging averaging     = Averaging::Running;
+        // > 0: Segmentlänge aus Fensterdauer bzw. Auflösung und Abtastrate
+        // (ersetzt segmentLength, folgt setSampleRate)
+        double    segmentSeconds = 0.0;
+        double    resolutionHz   = 0.0;
+        // > 0: Zoom-Modus, nur 0 .. zoomMaxHz im Raster zoomStepHz per
+        // Chirp-Z statt aller Bins bis fs/2 (bins()/binHz() folgen dem Raster)
+        double    zoomMaxHz      = 0.0;
+        double    zoomStepHz     = 0.0;
+    };
+
+    explicit WelchEstimator(double sampleRate);
+    WelchEstimator(double sampleRate, const Config &config, int channels = 1);
+
+    int channels() const { return m_channels; }
+
+    const Config &config() const { return m_config; }
+    void setConfig(const Config &config);
+
+    double sampleRate() const { return m_sampleRate; }
+    void   setSampleRate(double fs);
+
+    /// count Frames anhängen: Kanal c von Frame i liegt bei samples[i * stride + c]
+    /// (stride >= channels); liefert die Anzahl neu berechneter Segmente
+    int append(const double *samples, int count, int stride = 1);
+    /// Wie oben, aber ein Zeiger pro Kanal (z.B. SampleHistory-Sichten)
+    int append(const double *const *channels, int count);
+
+    void reset();
+
+    /// Index (z.B. im SampleHistory) des nächsten angehängten Frames
+    void setStreamIndex(qint64 index) { m_streamIndex = index; }
+    qint64 streamIndex() const { return m_streamIndex; }
+
+    /// Periodogramme über cache teilen; Kanal c erscheint dort als
+    /// firstChannel + c (nullptr = kein Cache)
+    void setCache(SpectralCache *cache, int firstChannel = 0);
+
+    /// Einseitige PSD (µV²/Hz) eines Kanals, segmentLength/2 + 1 Bins
+    QVector<double> psd(int channel = 0) const;
+    const double *psdData(int channel = 0) const
+    {
+        return m_psd.constData() + channel * bins();
+    }
+    /// Periodogramm des jüngsten Segments (gleiche Skalierung)
+    QVector<double> lastPeriodogram(int channel = 0) const;
+
+    /// Komplexe Bins jedes Segments aufheben (z.B. für Kreuzspektren);
+    /// das Segment wird dann immer transformiert, Cache-Treffer zählen nicht.
+    /// Im Zoom-Modus ohne Wirkung.
+    void setKeepSpectra(bool keep);
+    bool hasSpectra() const { return m_keepSpectra && !m_chirp; }
+    /// Unskalierte Bins des jüngsten Segments (gefenstert, mittelwertfrei),
+    /// bins() Werte je Kanal; nur mit hasSpectra()
+    const double *spectrumRe(int channel = 0) const
+    {
+        return m_spectrumRe.constData() + channel * bins();
+    }
+    const double *spectrumIm(int channel = 0) const
+    {
+        return m_spectrumIm.constData() + channel * bins();
+    }
+
+    double binHz()      const { return m_binHz; }
+    int    bins()       const { return m_bins; }
+    bool   isZoomed()   const { return m_chirp != nullptr; }
+    int    hopLength()  const { return m_hop; }
+    int    segmentsAveraged() const { return m_averaged; }
+    bool   isReady()    const { return m_averaged > 0; }
+
+    /// Zählt jedes neue Segment hoch (für Verbraucher, die nur auf Änderungen
+    /// reagieren); 0 nach reset() und configure(), also vor dem ersten Segment
+    quint64 generation() const { return m_generation; }
+
+private:
+    void configure();
+    bool advance(); // nach jedem geschriebenen Frame; true = neues Segment
+    void processSegment();
+    void computePeriodogram(double *periodogram);
+    void accumulate(const double *periodogram);
+    bool fetchCached(double *periodogram);
+    void storeCached(const double *periodogram);
+    SpectralCache::Key cacheKey(int channel) const;
+
+    Config m_config;
+    double m_sampleRate = 250.0;
+    int    m_channels   = 1;
+
+    std::shared_ptr<const FftPlan> m_plan;
+    std::shared_ptr<const ChirpZ>  m_chirp;  // nur im Zoom-Modus
+    ChirpZWorkspace   m_czWs;
+    int               m_bins  = 0;
+    double            m_binHz = 0.0;
+    QVector<double>   m_segment;     // gefenstertes Segment [n * channels + c]
+    QVector<double>   m_mean;        // Segment-Mittelwert je Kanal
+    FftBatchWorkspace m_ws;
+    QVector<double>  m_window;
+    double           m_scale = 1.0;  // 1 / (fs * sum(w^2))
+
+    // Eingangs-Ringpuffer (eine Segmentlänge, [pos * channels + c])
+    QVector<double>  m_ring;
+    int              m_writePos   = 0;
+    int              m_filled     = 0;
+    qint64           m_streamIndex = 0;
+    int              m_hop        = 512;
+
+    bool             m_keepSpectra = false;
+    QVector<double>  m_spectrumRe;    // [channel * bins + k]
+    QVector<double>  m_spectrumIm;
+
+    SpectralCache   *m_cache        = nullptr;
+    int              m_firstChannel = 0;
+
+    // Mittelung, jeweils [channel * bins + k]
+    QVector<double>  m_psd;
+    QVector<double>  m_lastPeriodogram;
+    QVector<double>  m_sum;           // Running: Summe der letzten N Periodogramme
+    QVector<double>  m_history;       // Running: N * channels * bins, Ringpuffer
+    int              m_historyPos = 0;
+    int              m_averaged   = 0;
+    int              m_sinceResum = 0;
+    quint64          m_generation = 0;
+};
+
+#endif // WELCHESTIMATOR_H
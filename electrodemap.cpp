@@ -1,33 +1,82 @@
 #include "electrodemap.h"
+#include "EegChannels.h"
+
 #include <QBrush>
+#include <QElapsedTimer>
 #include <QFont>
 #include <QFontMetrics>
 #include <QGraphicsEllipseItem>
-#include <QGraphicsPixmapItem>
 #include <QGraphicsSimpleTextItem>
 #include <QImage>
+#include <QMetaObject>
+#include <QPainter>
 #include <QPainterPath>
 #include <QPen>
-#include <QPixmap>
+#include <QStyleOptionGraphicsItem>
 #include <QtMath>
+#include <algorithm>
+
+namespace {
+
+// Zeichnet das Bild aus TopoHeatmap direkt (ohne QPixmap-Kopie pro Update).
+// Die Geometrie hängt nur von der Fläche in Szeneneinheiten ab, ein Update
+// ist damit nur update() und lässt den BSP-Index der Szene unberührt. Die
+// Stufe wählt ElectrodeMap::setHeatmapResolution (Zoom der Ansicht);
+// paint() zeichnet nur die gezeigte Stufe, skaliert auf die Fläche.
+class HeatmapItem : public QGraphicsItem {
+public:
+  explicit HeatmapItem(TopoHeatmap *renderer) : renderer(renderer) {}
+
+  QRectF boundingRect() const override {
+    // Bildmitte entspricht Szene (0, 0)
+    return QRectF(-renderer->width() / 2, -renderer->height() / 2,
+                  renderer->width(), renderer->height());
+  }
+
+  void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
+             QWidget *) override {
+    // Bild der Stufe deckt (Pixel / Auflösung) Szeneneinheiten um (0, 0)
+    const QImage &image = renderer->image();
+    const double scale = renderer->resolution();
+    const QSizeF size(image.width() / scale, image.height() / scale);
+    painter->drawImage(QRectF(QPointF(-size.width() / 2, -size.height() / 2),
+                              size),
+                       image);
+  }
+
+private:
+  TopoHeatmap *renderer;
+};
+
+} // namespace
 
 ElectrodeMap::ElectrodeMap(QObject *parent) : QGraphicsScene(parent) {
+  levelPool.setMaxThreadCount(1);
   // Beschriftungen für später
-  labels = {"Fp1", "Fp2", "F7", "F8", "Fz", "Pz", "T5", "T6", "Ref"};
+  labels = eegChannelLabels();
+  labels << "Ref";
 
-  // Positionen 10-20 System (8 Kanäle + Referenz)
+  // Positionen 10-20 System (8 Kanäle + Referenz): Polarwinkel vom Vertex
+  // und Azimut von der Nase (rechts positiv), auf den Kopf projiziert wie
+  // in der Heatmap-Interpolation
   double headR = 80;
-  positions = {
-      {-headR * 0.25, -headR * 0.9}, // Fp1 (Wiederhergestellt)
-      {headR * 0.25, -headR * 0.9},  // Fp2
-      {-headR * 0.5, -headR * 0.7},  // F7
-      {headR * 0.5, -headR * 0.7},   // F8
-      {0, -headR * 0.3},             // Fz
-      {0, headR * 0.25},             // Pz
-      {-headR * 0.7, headR * 0.5},   // T5
-      {headR * 0.7, headR * 0.5},    // T6
-      {0, 0}                         // Referenz (R)
+  const struct {
+    double polar, azimuth;
+  } tenTwenty[] = {
+      {72, -18},  // Fp1
+      {72, 18},   // Fp2
+      {72, -54},  // F7
+      {72, 54},   // F8
+      {36, 0},    // Fz
+      {36, 180},  // Pz
+      {72, -126}, // T5
+      {72, 126},  // T6
+      {0, 0}      // Referenz (R), Vertex
   };
+  positions.clear();
+  for (const auto &p : tenTwenty)
+    positions.append(
+        TopoHeatmap::projectTenTwenty(p.polar, p.azimuth, headR));
 
   offsets.resize(labels.size());
   for (int i = 0; i < offsets.size(); ++i)
@@ -35,18 +84,40 @@ ElectrodeMap::ElectrodeMap(QObject *parent) : QGraphicsScene(parent) {
 
   // Beispiel: T5 (Index 6) ein wenig nach rechts und unten schieben
   offsets[6] = QPointF(0.5, 1.0);
+
+  heatmapRenderer.setLayout(positions, headR);
+  heatmapRenderer.setSize(300, 300);
+
+  // Szene einmal aufbauen; Updates tauschen nur noch Inhalte
+  drawHead();
+  heatmapItem = new HeatmapItem(&heatmapRenderer);
+  heatmapItem->setZValue(-1);
+  addItem(heatmapItem);
+  drawElectrodes();
+  showActivities(false);
+}
+
+ElectrodeMap::~ElectrodeMap() { levelPool.waitForDone(); }
+
+void ElectrodeMap::showActivities(bool visible) {
+  heatmapItem->setVisible(visible);
+  for (QGraphicsEllipseItem *item : electrodeItems)
+    item->setVisible(visible);
 }
 
 void ElectrodeMap::reset() {
-  clear();
-  drawHead();
+  showActivities(false);
+  clearConnections();
 }
 
 void ElectrodeMap::setActivities(const QVector<double> &activities) {
-  clear();
-  drawHead();
+  QElapsedTimer timer;
+  timer.start();
   drawHeatmap(activities);
-  drawElectrodes(activities);
+  showActivities(true);
+  // Nach neuer Elektrodenzahl zeigt TopoHeatmap die Grundstufe
+  buildHeatmapLevel();
+  lastUpdateTimeUs = timer.nsecsElapsed() / 1000.0;
 }
 
 void ElectrodeMap::drawHead() {
@@ -71,73 +142,62 @@ void ElectrodeMap::drawHead() {
 }
 
 void ElectrodeMap::drawHeatmap(const QVector<double> &activities) {
-  double headR = 80;
-  int imgW = 300;
-  int imgH = 300;
-
-  QImage heatmap(imgW, imgH, QImage::Format_ARGB32);
-  heatmap.fill(Qt::transparent);
-
-  // Bildmitte bei (150, 150) entspricht Szene (0, 0)
-  double offsetX = 150.0;
-  double offsetY = 150.0;
-
-  for (int y = 0; y < imgH; ++y) {
-    double py = double(y) - offsetY;
-    for (int x = 0; x < imgW; ++x) {
-      double px = double(x) - offsetX;
-
-      // Innerhalb des Kopfovals?
-      double e = (px * px) / (headR * headR) +
-                 (py * py) / ((1.1 * headR) * (1.1 * headR));
-      if (e > 1.0)
-        continue;
-
-      double sumW = 0.0;
-      double sumA = 0.0;
-      for (int i = 0; i < activities.size() && i < positions.size(); ++i) {
-        double dx = px - positions[i].x();
-        double dy = py - positions[i].y();
-        double d = qSqrt(dx * dx + dy * dy) + 0.01;
-        double w = 1.0 / (d * d);
-        sumW += w;
-        sumA += w * activities[i];
-      }
-      double val = (sumW > 0.0 ? sumA / sumW : 0.0);
-      val = qBound(0.0, val, 1.0);
+  // Maske und IDW-Gewichte liegen in heatmapRenderer (einmal je Layout)
+  heatmapRenderer.render(activities);
+  heatmapItem->update();
+}
 
-      int r = int(255 * val);
-      int g = int(255 * (1.0 - val));
-      heatmap.setPixelColor(x, y, QColor(r, g, 0, 140));
-    }
-  }
+void ElectrodeMap::setHeatmapResolution(double pixelsPerUnit) {
+  const double shown = heatmapRenderer.resolution();
+  heatmapRenderer.setResolution(pixelsPerUnit);
+  if (heatmapRenderer.resolution() != shown) // Stufe lag schon vor
+    heatmapItem->update();
+  buildHeatmapLevel();
+}
 
-  heatmapItem = addPixmap(QPixmap::fromImage(heatmap));
-  heatmapItem->setPos(-150, -150);
-  heatmapItem->setZValue(-1);
+void ElectrodeMap::buildHeatmapLevel() {
+  // Ein Job zur Zeit; am Ende wird die inzwischen angefragte Stufe
+  // nachgeschoben
+  if (levelJobRunning || !heatmapRenderer.levelPending())
+    return;
+  levelJobRunning = true;
+  const TopoHeatmap::LevelSpec spec = heatmapRenderer.pendingLevel();
+  levelPool.start([this, spec]() {
+    const TopoHeatmap::Level level = TopoHeatmap::buildLevel(spec);
+    QMetaObject::invokeMethod(
+        this,
+        [this, level]() {
+          levelJobRunning = false;
+          // Veraltet (neue Geometrie) -> verworfen
+          if (heatmapRenderer.addLevel(level))
+            heatmapItem->update();
+          buildHeatmapLevel();
+        },
+        Qt::QueuedConnection);
+  });
 }
 
-void ElectrodeMap::drawElectrodes(const QVector<double> &activities) {
+void ElectrodeMap::drawElectrodes() {
   QPen ePen(Qt::black, 1);
   QBrush eBrush(Qt::gray);
   double eSz = 14;
 
+  QFont font("Arial");
+  font.setPixelSize(6);
+  font.setBold(true);
+
   for (int i = 0; i < positions.size(); ++i) {
-    double activity = (i < activities.size()) ? activities[i] : 0.0;
     // Marker
     QPen penEdge = (i == positions.size() - 1 ? QPen(Qt::black, 2) : ePen);
     QBrush brushBg = (i == positions.size() - 1 ? QBrush(Qt::white) : eBrush);
 
-    QFont font("Arial");
-    font.setPixelSize(6);
-    font.setBold(true);
-
     // Elektrode relativ zum eigenen Ursprung (0,0) erstellen und dann
     // positionieren
     QGraphicsEllipseItem *elItem =
         addEllipse(-eSz / 2.0, -eSz / 2.0, eSz, eSz, penEdge, brushBg);
     elItem->setPos(positions[i]);
     elItem->setZValue(10);
+    electrodeItems.append(elItem);
 
     // Label als Kind der Elektrode -> (0,0) ist jetzt die Mitte der Elektrode
     QGraphicsSimpleTextItem *text =
@@ -151,4 +211,88 @@ void ElectrodeMap::drawElectrodes(const QVector<double> &activities) {
     text->setPos(-br.width() / 2.0 + offsets[i].x(),
                  -br.height() / 2.0 + offsets[i].y());
   }
+
+  applyImpedances();
+}
+
+void ElectrodeMap::setImpedances(const QVector<double> &kOhm) {
+  impedances = kOhm;
+  applyImpedances();
+}
+
+void ElectrodeMap::clearImpedances() {
+  impedances.clear();
+  applyImpedances();
+}
+
+void ElectrodeMap::applyImpedances() {
+  // Referenz (letzter Eintrag) hat keinen eigenen Messkanal
+  for (int i = 0; i < electrodeItems.size() - 1; ++i) {
+    QGraphicsEllipseItem *elItem = electrodeItems[i];
+    double z = (i < impedances.size()) ? impedances[i] : -1.0;
+
+    if (!(z >= 0.0)) { // NaN oder fehlend
+      elItem->setPen(QPen(Qt::black, 1));
+      elItem->setToolTip(QString());
+      continue;
+    }
+
+    // Gleiche Schwellen wie im Impedanz-Dialog
+    QColor color = (z < 10.0)   ? QColor("#50FA7B")
+                   : (z < 50.0) ? QColor("#F1FA8C")
+                                : QColor("#FF5555");
+    elItem->setPen(QPen(color, 3));
+    elItem->setToolTip(
+        QString("%1: %2 kOhm").arg(labels[i]).arg(z, 0, 'f', 1));
+  }
+}
+
+void ElectrodeMap::setConnections(const QVector<double> &values, int n,
+                                  double threshold) {
+  connections = values;
+  connectionChannels = (values.size() >= n * n) ? n : 0;
+  connectionThreshold = qBound(0.0, threshold, 0.99);
+  drawConnections();
+}
+
+void ElectrodeMap::clearConnections() {
+  connections.clear();
+  connectionChannels = 0;
+  drawConnections();
+}
+
+void ElectrodeMap::drawConnections() {
+  // Eine Linie je Kanalpaar mit fester Geometrie, einmal angelegt und danach
+  // nur ein-/ausgeblendet und umgefärbt
+  const int n = connectionChannels;
+  const int pairs = int(positions.size()) - 1; // ohne Referenz
+  const int shown = std::min(n, pairs);
+  if (connectionItems.isEmpty())
+    connectionItems.fill(nullptr, pairs * pairs);
+
+  for (int i = 0; i < pairs; ++i) {
+    for (int j = i + 1; j < pairs; ++j) {
+      QGraphicsLineItem *&line = connectionItems[i * pairs + j];
+      const double v = (i < shown && j < shown) ? connections[i * n + j] : 0.0;
+      if (!(v >= connectionThreshold)) {
+        if (line)
+          line->setVisible(false);
+        continue;
+      }
+      if (!line) {
+        line = addLine(QLineF(positions[i], positions[j]));
+        line->setZValue(5); // über der Heatmap, unter den Elektroden
+      }
+
+      // Stärke -> Breite und Deckkraft
+      const double t =
+          (v - connectionThreshold) / (1.0 - connectionThreshold);
+      QColor color(40, 90, 200, 60 + int(195 * qBound(0.0, t, 1.0)));
+      line->setPen(QPen(color, 1.0 + 4.0 * t, Qt::SolidLine, Qt::RoundCap));
+      line->setToolTip(QString("%1 - %2: %3")
+                           .arg(labels[i], labels[j])
+                           .arg(v, 0, 'f', 2));
+      line->setVisible(true);
+    }
+  }
 }
@@ -1,23 +1,58 @@
 #pragma once
-#include <QGraphicsPixmapItem>
+#include "TopoHeatmap.h"
+
+#include <QGraphicsEllipseItem>
+#include <QGraphicsItem>
+#include <QGraphicsLineItem>
 #include <QGraphicsScene>
 #include <QPointF>
 #include <QStringList>
+#include <QThreadPool>
 #include <QVector>
 
 class ElectrodeMap : public QGraphicsScene {
   Q_OBJECT
 public:
   explicit ElectrodeMap(QObject *parent = nullptr);
+  ~ElectrodeMap() override;
+  // Kopf und Elektroden bleiben stehen, neu ist nur das Heatmap-Bild
   void setActivities(const QVector<double> &activities);
   void reset();
+  // Dauer des letzten setActivities (µs, ohne das spätere Zeichnen)
+  double lastUpdateUs() const { return lastUpdateTimeUs; }
+  // Benötigte Heatmap-Pixel je Szeneneinheit (Zoom der Ansicht mal
+  // Geräte-Pixelverhältnis); fehlende Stufen entstehen im Hintergrund
+  void setHeatmapResolution(double pixelsPerUnit);
+  // Heatmap-Pixel je Szeneneinheit der gezeigten Stufe
+  double heatmapResolution() const { return heatmapRenderer.resolution(); }
+  // Live-Impedanz pro Kanal (kOhm, NaN = noch kein Wert)
+  void setImpedances(const QVector<double> &kOhm);
+  void clearImpedances();
+  // Verbindungen als Kanten: values[i * n + j] in 0..1, Kanten ab threshold
+  void setConnections(const QVector<double> &values, int n,
+                      double threshold = 0.3);
+  void clearConnections();
 
 private:
-  QStringList labels{"Fp1", "Fp2", "F7", "F8", "Fz", "Pz", "T5", "T6", "Ref"};
+  QStringList labels; // Kanäle + Referenz
   QVector<QPointF> positions;
   QVector<QPointF> offsets;
-  QGraphicsPixmapItem *heatmapItem = nullptr;
+  QGraphicsItem *heatmapItem = nullptr;
+  TopoHeatmap heatmapRenderer;
+  QThreadPool levelPool; // rechnet fehlende Zoomstufen der Heatmap
+  bool levelJobRunning = false;
+  QVector<QGraphicsEllipseItem *> electrodeItems;
+  QVector<double> impedances;
+  QVector<double> connections;
+  int connectionChannels = 0;
+  double connectionThreshold = 0.3;
+  QVector<QGraphicsLineItem *> connectionItems; // [i * paare + j], lazy
+  double lastUpdateTimeUs = 0.0;
   void drawHead();
-  void drawElectrodes(const QVector<double> &activities);
+  void drawElectrodes();
+  void showActivities(bool visible);
   void drawHeatmap(const QVector<double> &activities);
+  void buildHeatmapLevel();
+  void applyImpedances();
+  void drawConnections();
 };
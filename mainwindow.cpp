@@ -1,11 +1,23 @@
 #include "mainwindow.h"
 
 #include "AbstractDataSource.h"
+#include "BandPowerMatrix.h"
+#include "BandPowerTracker.h"
 #include "BleDataSource.h"
 #include "DataProcessingQt.h"
 #include "DummyDataSource.h"
+#include "EegChannels.h"
+#include "EegMontageView.h"
 #include "FileDataSource.h"
+#include "ProcessingPipeline.h"
 #include "RealDataSource.h"
+#include "RenderScheduler.h"
+#include "RunningRms.h"
+#include "SampleHistory.h"
+#include "SpectralAnalyzer.h"
+#include "SpectrogramWidget.h"
+#include "StreamingGraph.h"
+#include "WelchEstimator.h"
 #include "electrodemap.h"
 #include "qcustomplot.h"
 #include "zoomablegraphicsview.h"
@@ -25,10 +37,12 @@
 #include <QRandomGenerator>
 #include <QSpinBox>
 #include <QStandardPaths>
+#include <QTimer>
 #include <QWidget>
 #include <QtMath>
 #include <algorithm>
 #include <cmath>
+#include <utility>
 
 // -----------------------------------------------------------------------------
 // Konstruktor / Destruktor
@@ -64,7 +78,7 @@ MainWindow::MainWindow(QWidget *parent)
   // Unten rechts: FFT-Plot
   fftPlot = new QCustomPlot(this);
   fftPlot->xAxis->setLabel("Frequency (Hz)");
-  fftPlot->yAxis->setLabel("Amplitude (a.u.)");
+  fftPlot->yAxis->setLabel("Amplitude (µV/√Hz)");
   fftPlot->xAxis->setRange(0, 100);
   fftPlot->yAxis->setRange(0, 1.0);
 
@@ -86,10 +100,63 @@ MainWindow::MainWindow(QWidget *parent)
 
   fftToolsLayout->addWidget(new QLabel("FFT Range:", this));
   fftToolsLayout->addWidget(fftRangeCombo);
+
+  // Zoom-FFT: nur 0 .. Range, aber in feinem Raster (Chirp-Z)
+  fftZoomCheckBox = new QCheckBox(
+      QString("Zoom (%1 Hz)").arg(fftZoomStepHz, 0, 'f', 2), this);
+  fftZoomCheckBox->setToolTip(
+      tr("Chirp-Z spectrum of the selected range only, fine frequency grid"));
+  fftToolsLayout->addWidget(fftZoomCheckBox);
+
+  // Welch: Segmentlänge, Overlap, Mittelungstiefe
+  // Segment als Fensterdauer: FFT-Länge folgt der Abtastrate (Mixed-Radix,
+  // z.B. 3 s -> 750 bei 250 SPS, 6000 bei 2000 SPS), Auflösung = 1/Dauer
+  welchSegmentCombo = new QComboBox(this);
+  for (double sec : {0.5, 1.0, 2.0, 3.0, 4.0})
+    welchSegmentCombo->addItem(
+        QString("%1 s (%2 Hz)").arg(sec).arg(1.0 / sec, 0, 'f', 2), sec);
+  welchSegmentCombo->setCurrentIndex(3);
+  welchConfig.segmentSeconds = welchSegmentCombo->currentData().toDouble();
+
+  welchOverlapCombo = new QComboBox(this);
+  welchOverlapCombo->addItem("0 %", 0.0);
+  welchOverlapCombo->addItem("50 %", 0.5);
+  welchOverlapCombo->addItem("75 %", 0.75);
+  welchOverlapCombo->addItem("87.5 %", 0.875);
+  welchOverlapCombo->setCurrentIndex(2);
+
+  welchAveragesSpin = new QSpinBox(this);
+  welchAveragesSpin->setRange(1, 64);
+  welchAveragesSpin->setValue(welchConfig.averages);
+
+  fftToolsLayout->addSpacing(10);
+  fftToolsLayout->addWidget(new QLabel("Window:", this));
+  fftToolsLayout->addWidget(welchSegmentCombo);
+  fftToolsLayout->addWidget(new QLabel("Overlap:", this));
+  fftToolsLayout->addWidget(welchOverlapCombo);
+  fftToolsLayout->addWidget(new QLabel("Averages:", this));
+  fftToolsLayout->addWidget(welchAveragesSpin);
   fftToolsLayout->addStretch();
 
+  // Spektrogramm neben dem FFT-Plot, Kanal wählbar
+  spectrogram = new SpectrogramWidget(this);
+  spectrogram->setToolTip(tr("Spectrogram (dB µV²/Hz, ~1 s window)"));
+
+  spectrogramChannelCombo = new QComboBox(this);
+  {
+    for (int ch = 0; ch < numChannels; ++ch)
+      spectrogramChannelCombo->addItem(eegChannelLabel(ch), ch);
+  }
+  fftToolsLayout->addSpacing(10);
+  fftToolsLayout->addWidget(new QLabel("Spectrogram:", this));
+  fftToolsLayout->addWidget(spectrogramChannelCombo);
+
+  auto *spectrumRowLayout = new QHBoxLayout();
+  spectrumRowLayout->addWidget(fftPlot, 1);
+  spectrumRowLayout->addWidget(spectrogram, 1);
+
   rightMasterLayout->addLayout(fftToolsLayout);
-  rightMasterLayout->addWidget(fftPlot, 2);
+  rightMasterLayout->addLayout(spectrumRowLayout, 2);
 
   connect(fftRangeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
           [this](int index) {
@@ -98,38 +165,120 @@ MainWindow::MainWindow(QWidget *parent)
               fftPlot->xAxis->setRange(0, range);
               fftPlot->replot(QCustomPlot::rpQueuedReplot);
             }
+            if (spectrogram)
+              spectrogram->setMaxFrequency(
+                  fftRangeCombo->itemData(index).toDouble());
+            applyFftZoom();
           });
+  connect(fftZoomCheckBox, &QCheckBox::toggled, this,
+          [this]() { applyFftZoom(); });
+
+  connect(welchSegmentCombo,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          &MainWindow::applyWelchConfig);
+  connect(welchOverlapCombo,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          &MainWindow::applyWelchConfig);
+  connect(welchAveragesSpin, QOverload<int>::of(&QSpinBox::valueChanged), this,
+          &MainWindow::applyWelchConfig);
+  connect(spectrogramChannelCombo,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          &MainWindow::applySpectrogramConfig);
 
   // -------------------------------------------------------------------------
   // Links: EEG-Kanalplots
   // -------------------------------------------------------------------------
   QStringList colors = {"red",  "green", "blue",   "magenta",
                         "cyan", "brown", "orange", "gray"};
-  QStringList labels = {"Fp1", "Fp2", "F7", "F8", "Fz", "Pz", "T5", "T6"};
+
+  traceModeCombo = new QComboBox(this);
+  traceModeCombo->addItem("Stacked montage", TraceMontage);
+  traceModeCombo->addItem("Montage (sweep)", TraceSweep);
+  traceModeCombo->addItem("Per-channel plots", TracePerChannel);
+  auto *traceToolsLayout = new QHBoxLayout();
+  traceToolsLayout->addWidget(new QLabel("Traces:", this));
+  traceToolsLayout->addWidget(traceModeCombo);
+  traceToolsLayout->addStretch();
+  leftColumnLayout->addLayout(traceToolsLayout);
+
+  // Montage: eine Zeitachse, ein paintEvent für alle Kanäle
+  montageView = new EegMontageView(this);
+  QStringList montageLabels;
+  QVector<QColor> montageColors;
+  for (int i = 0; i < numChannels; ++i) {
+    montageLabels << eegChannelLabel(i);
+    montageColors << QColor(colors.value(i));
+  }
+  montageView->setChannels(montageLabels, montageColors);
+  montageView->setWindowSeconds(traceWindowSeconds);
+  leftColumnLayout->addWidget(montageView, 1);
 
   for (int i = 0; i < numChannels; ++i) {
     QCustomPlot *plot = new QCustomPlot(this);
     channelPlots.append(plot);
     leftColumnLayout->addWidget(plot);
+    plot->setVisible(false);
 
-    plot->addGraph();
-    plot->graph(0)->setPen(QPen(QColor(colors.value(i))));
+    auto *graph = new StreamingGraph(plot->xAxis, plot->yAxis);
+    graph->setPen(QPen(QColor(colors.value(i))));
+    channelGraphs.append(graph);
     plot->xAxis->setLabel("Time (s)");
     plot->yAxis->setLabel(
-        QString("%1 (µV)").arg(labels.value(i, QString("Ch%1").arg(i + 1))));
+        QString("%1 (µV)").arg(eegChannelLabel(i)));
 
-    plot->xAxis->setRange(0, 3);          // 3s Fenster
+    plot->xAxis->setRange(0, traceWindowSeconds);
     plot->yAxis->setRange(-100.0, 100.0); // Startbereich ±100 µV
     plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
     plot->axisRect()->setRangeZoom(Qt::Vertical);
   }
 
+  connect(traceModeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, [this]() {
+            // Nur die sichtbare Ansicht wird gefüttert; die andere beginnt leer
+            const int mode = traceModeCombo->currentData().toInt();
+            const bool montage = mode != TracePerChannel;
+            montageView->setRenderMode(mode == TraceSweep
+                                           ? EegMontageView::SweepMode
+                                           : EegMontageView::ScrollMode);
+            montageView->setVisible(montage);
+            montageView->clear();
+            for (QCustomPlot *plot : std::as_const(channelPlots))
+              plot->setVisible(!montage);
+            for (StreamingGraph *graph : std::as_const(channelGraphs))
+              graph->clear();
+          });
+
   channelPhases.resize(numChannels);
   for (int i = 0; i < numChannels; ++i)
     channelPhases[i] = QRandomGenerator::global()->generateDouble() * 2 * M_PI;
 
-  fftBuffers.resize(numChannels);
-  headBuffers.resize(numChannels);
+  // Gemeinsamer Verlauf aller Kanäle nach der DSP-Kette
+  history = new SampleHistory(numChannels, historyCapacity());
+
+  // Welch pro Kanal (FFT-Plot + Bandpower teilen die Spektren) und
+  // Spektrogramm laufen im Thread-Pool und lesen aus dem Verlauf
+  analyzer = new SpectralAnalyzer(history, numChannels);
+  analyzer->setSampleRate(currentSampleRate);
+  analyzer->setWelchConfig(welchConfig);
+  applySpectrogramConfig();
+
+  // Laufender RMS je Kanal für die Head-Map (O(1) pro Sample)
+  headRms = new RunningRms(numChannels, currentSampleRate, 2.0);
+
+  // Sliding-DFT-Bandleistung für Neurofeedback (1 s Fenster)
+  bandTracker = new BandPowerTracker(numChannels, currentSampleRate, 1.0);
+  latencyClock.start();
+
+  // Spuren mit bis zu 30 Hz, bei Last herunter bis 10 Hz; FFT, Bandpower
+  // und Head-Plot im selben Takt, nach Wanduhr gedrosselt
+  renderScheduler = new RenderScheduler(&latencyClock, this);
+  renderScheduler->setTargetFps(30.0);
+  renderScheduler->setMinFps(10.0);
+  connect(renderScheduler, &RenderScheduler::frame, this,
+          &MainWindow::renderFrame);
+  renderScheduler->start();
+
+  buildPipeline();
 
   // -------------------------------------------------------------------------
   // Links unten: Data source + UDP-Port + Start/Stop/Reset
@@ -160,11 +309,14 @@ MainWindow::MainWindow(QWidget *parent)
   stopButton = new QPushButton("Stop / Disconnect", this);
   resetButton = new QPushButton("Reset", this);
   impedanceButton = new QPushButton("Check Impedance", this);
+  liveImpedanceButton = new QPushButton("Live Impedance", this);
+  liveImpedanceButton->setCheckable(true);
 
   auto *btnLayout = new QHBoxLayout();
   btnLayout->addWidget(startButton);
   btnLayout->addWidget(stopButton);
   btnLayout->addWidget(impedanceButton);
+  btnLayout->addWidget(liveImpedanceButton);
 
   leftColumnLayout->addLayout(sourceLayout);
   leftColumnLayout->addLayout(btnLayout);
@@ -285,21 +437,84 @@ MainWindow::MainWindow(QWidget *parent)
   }
   bandPowerPlot->xAxis->setRange(0.5, 5.5);
 
+  bandPowerChannelCombo = new QComboBox(this);
+  bandPowerChannelCombo->addItem("Average", -1);
+  for (int ch = 0; ch < numChannels; ++ch)
+    bandPowerChannelCombo->addItem(eegChannelLabel(ch), ch);
+
+  auto *bandPowerToolsLayout = new QHBoxLayout();
+  bandPowerToolsLayout->addWidget(new QLabel("Channel:", this));
+  bandPowerToolsLayout->addWidget(bandPowerChannelCombo);
+  bandPowerToolsLayout->addStretch();
+
+  centerColumnLayout->addLayout(bandPowerToolsLayout);
   centerColumnLayout->addWidget(bandPowerPlot);
 
+  connect(bandPowerChannelCombo,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          &MainWindow::refreshBandPowerPlot);
+
   // Head Plot
   electrodePlacementScene = new ElectrodeMap(this);
 
   electrodePlacementView = new ZoomableGraphicsView(this);
   electrodePlacementView->setScene(electrodePlacementScene);
+  // Heatmap-Auflösung folgt dem Zoom, nicht dem Zeichnen
+  connect(electrodePlacementView, &ZoomableGraphicsView::resolutionChanged,
+          electrodePlacementScene, &ElectrodeMap::setHeatmapResolution);
   electrodePlacementView->setRenderHint(QPainter::Antialiasing, true);
   electrodePlacementView->setMinimumHeight(300);
   electrodePlacementView->setMinimumWidth(300);
   electrodePlacementView->setStyleSheet(
       "background-color: white; border: none;");
 
+  // Topomap: Gesamtleistung, ein einzelnes Band oder laufender RMS
+  headMapBandCombo = new QComboBox(this);
+  headMapBandCombo->addItem("Total power", -1);
+  headMapBandCombo->addItem("RMS (2 s window)", HeadMapRmsWindow);
+  headMapBandCombo->addItem("RMS (exponential, 2 s)", HeadMapRmsExponential);
+  const auto mapBands = BandPowerTracker::defaultBands();
+  for (int b = 0; b < mapBands.size(); ++b)
+    headMapBandCombo->addItem(
+        QString("%1 (%2-%3 Hz)")
+            .arg(mapBands[b].name.left(1).toUpper() + mapBands[b].name.mid(1))
+            .arg(mapBands[b].lowHz)
+            .arg(mapBands[b].highHz),
+        b);
+
+  // Konnektivität als Kanten (Band wie Topomap, sonst Mittel aller Bänder)
+  connectivityCombo = new QComboBox(this);
+  connectivityCombo->addItem("No connections", -1);
+  connectivityCombo->addItem(
+      "Coherence", int(ConnectivityEstimator::Measure::Coherence));
+  connectivityCombo->addItem("PLV", int(ConnectivityEstimator::Measure::Plv));
+
+  auto *headToolsLayout = new QHBoxLayout();
+  headToolsLayout->addWidget(new QLabel("Topomap:", this));
+  headToolsLayout->addWidget(headMapBandCombo);
+  headToolsLayout->addWidget(connectivityCombo);
+  headToolsLayout->addStretch();
+
+  centerColumnLayout->addLayout(headToolsLayout);
   centerColumnLayout->addWidget(electrodePlacementView, 0, Qt::AlignCenter);
 
+  connect(headMapBandCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+          this, [this]() {
+            const int mode = headMapBandCombo->currentData().toInt();
+            if (mode == HeadMapRmsWindow || mode == HeadMapRmsExponential)
+              headRms->setMode(mode == HeadMapRmsWindow
+                                   ? RunningRms::Mode::Window
+                                   : RunningRms::Mode::Exponential);
+            updateElectrodePlacement();
+          });
+  connect(connectivityCombo,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          [this]() {
+            analyzer->setConnectivity(
+                connectivityCombo->currentData().toInt() >= 0);
+            updateElectrodePlacement();
+          });
+
   // -------------------------------------------------------------------------
   // Rechts: Theta/Beta-Balkendiagramm + Fokus-Ampel
   // -------------------------------------------------------------------------
@@ -343,6 +558,19 @@ MainWindow::MainWindow(QWidget *parent)
 
   rightColumnLayout->addWidget(focusIndicator, 0, Qt::AlignHCenter);
 
+  latencyLabel = new QLabel(this);
+  latencyLabel->setAlignment(Qt::AlignCenter);
+  latencyLabel->setToolTip(
+      tr("Latency from sample arrival to focus indicator update"));
+  rightColumnLayout->addWidget(latencyLabel, 0, Qt::AlignHCenter);
+
+  // Theta/Beta + Fokus mit Display-Rate (30 Hz) aus dem Tracker
+  feedbackTimer = new QTimer(this);
+  feedbackTimer->setTimerType(Qt::PreciseTimer);
+  connect(feedbackTimer, &QTimer::timeout, this,
+          &MainWindow::publishNeurofeedback);
+  feedbackTimer->start(1000 / 30);
+
   // -------------------------------------------------------------------------
   // Datenquelle + DataProcessingQt
   // -------------------------------------------------------------------------
@@ -357,6 +585,10 @@ MainWindow::MainWindow(QWidget *parent)
       dataSource = nullptr;
     }
 
+    // Lead-Off-Anregung gehört zur alten Quelle
+    if (liveImpedanceButton)
+      liveImpedanceButton->setChecked(false);
+
     dataSource = src;
     currentSampleRate = src->sampleRate();
 
@@ -371,6 +603,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     dataProcessor =
         new DataProcessingQt(numChannels, currentSampleRate, hpOn, ntOn, bpOn);
+    updatePipelineConfig();
 
     connect(src, &AbstractDataSource::newEEGData, this,
             &MainWindow::handleNewEEGData);
@@ -379,6 +612,11 @@ MainWindow::MainWindow(QWidget *parent)
         [this](const QString &msg) { this->statusBar()->showMessage(msg); });
     connect(src, &AbstractDataSource::impedanceReceived, this,
             &MainWindow::displayImpedance);
+    connect(src, &AbstractDataSource::impedanceUpdated, this,
+            [this](const QVector<double> &kOhm) {
+              if (electrodePlacementScene)
+                electrodePlacementScene->setImpedances(kOhm);
+            });
   };
 
   // Default: Simulation
@@ -514,6 +752,24 @@ MainWindow::MainWindow(QWidget *parent)
     }
   });
 
+  // Kontinuierliche Impedanz (AC-Lead-Off + Goertzel in der Datenquelle)
+  connect(liveImpedanceButton, &QPushButton::toggled, this, [this](bool on) {
+    if (dataSource)
+      dataSource->setLeadOffExcitation(on);
+    if (!on && electrodePlacementScene)
+      electrodePlacementScene->clearImpedances();
+    // Aktiv erst mit der Bestätigung des Geräts (statusMessage der Quelle)
+    statusBar()->showMessage(on ? "Requesting lead-off excitation..."
+                                : "Live impedance monitoring disabled.");
+  });
+
+  // Laufzeiten der Pipeline-Stufen (Details im Tooltip)
+  pipelineStatsLabel = new QLabel(this);
+  statusBar()->addPermanentWidget(pipelineStatsLabel);
+  auto *statsTimer = new QTimer(this);
+  connect(statsTimer, &QTimer::timeout, this, &MainWindow::updatePipelineStats);
+  statsTimer->start(1000);
+
   updateElectrodePlacement();
   updateThetaBetaBars();
   updateBandPowerPlot(BandPower{0, 0, 0, 0, 0});
@@ -521,6 +777,18 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 MainWindow::~MainWindow() {
+  delete pipeline;
+  pipeline = nullptr;
+
+  delete analyzer; // wartet auf laufende Jobs
+  analyzer = nullptr;
+  delete history;
+  history = nullptr;
+  delete bandTracker;
+  bandTracker = nullptr;
+  delete headRms;
+  headRms = nullptr;
+
   if (dataProcessor) {
     delete dataProcessor;
     dataProcessor = nullptr;
@@ -532,130 +800,382 @@ MainWindow::~MainWindow() {
 // -----------------------------------------------------------------------------
 
 void MainWindow::handleNewEEGData(const QVector<double> &values) {
-  if (values.isEmpty())
+  if (values.isEmpty() || !pipeline)
     return;
 
   const double dt =
       (currentSampleRate > 0.0) ? (1.0 / currentSampleRate) : 0.02;
+  if (!pendingSamples.isEmpty() && dt != pendingDt)
+    flushPipeline(); // ein Block hat genau ein dt
+
+  // Frames sammeln: Stufen, Zeitmessung und Queues laufen je Block
+  if (pendingSamples.isEmpty()) {
+    pendingStartTime = time;
+    pendingDt = dt;
+    pendingFirstIndex = sampleCounter;
+    pendingArrivalNs = latencyClock.nsecsElapsed();
+  }
+  const int offset = int(pendingSamples.size());
+  const int n = std::min(numChannels, int(values.size()));
+  pendingSamples.resize(offset + numChannels); // fehlende Kanäle = 0
+  std::copy(values.constBegin(), values.constBegin() + n,
+            pendingSamples.begin() + offset);
 
-  const double windowSec = 3.0;
+  time += dt;
+  ++sampleCounter;
+
+  // Abgegeben wird am Ende des laufenden Ereignis-Durchlaufs (alle Samples
+  // eines Pakets/Timer-Ticks in einem Block), spätestens nach ~10 ms Daten
+  const int maxFrames = std::max(1, int(currentSampleRate / 100.0));
+  if (int(pendingSamples.size()) >= maxFrames * numChannels) {
+    flushPipeline();
+  } else if (!flushScheduled) {
+    flushScheduled = true;
+    QTimer::singleShot(0, this, &MainWindow::flushPipeline);
+  }
+}
 
-  // Plot-Updates drosseln (~30 Hz Redraw)
-  static double accumPlots = 0.0;
-  accumPlots += dt;
-  bool doPlotUpdate = (accumPlots >= 1.0 / 30.0);
+void MainWindow::flushPipeline() {
+  flushScheduled = false;
+  if (pendingSamples.isEmpty() || !pipeline)
+    return;
 
-  // ---- erst filtern (Highpass + Notch + Bandlimit) ----
-  QVector<double> filtered = values;
-  if (dataProcessor) {
-    for (int ch = 0; ch < numChannels && ch < filtered.size(); ++ch) {
-      filtered[ch] = dataProcessor->processSample(ch, filtered[ch]);
-    }
-  }
+  FrameBlock block;
+  block.channels = numChannels;
+  block.sampleRate = 1.0 / pendingDt;
+  block.startTime = pendingStartTime;
+  block.dt = pendingDt;
+  block.firstIndex = pendingFirstIndex;
+  block.arrivalNs = pendingArrivalNs; // ältestes Frame: Latenz konservativ
+  block.samples.swap(pendingSamples);
+
+  pipeline->push(block);
+  pipeline->run();
+}
 
-  // ---- Time-Series Plots mit gefilterten Daten ----
-  for (int i = 0; i < numChannels && i < filtered.size(); ++i) {
-    QCustomPlot *plot = channelPlots[i];
-    if (!plot || plot->graphCount() == 0)
-      continue;
+// -----------------------------------------------------------------------------
+// Verarbeitungsgraph
+// -----------------------------------------------------------------------------
+//
+//   source -> dsp -> decimate -> traces
+//                 -> history -> fft -> spectrogram
+//                 -> bandtracker
+//                 -> headmap
+//                 -> recorder
+//
+// "history" schreibt in den gemeinsamen SampleHistory; "fft" stößt nur
+// die Jobs des SpectralAnalyzer an (Thread-Pool, lesen aus dem Verlauf),
+// "spectrogram" übernimmt die fertigen Spalten. FFT-Plot, Bandpower und
+// Head-Map zeichnet der RenderScheduler aus dem jüngsten Ergebnis.
+
+void MainWindow::buildPipeline() {
+  pipeline = new ProcessingPipeline();
+
+  using Kind = PipelineStage::Kind;
+
+  pipeline->addStage(new CallbackStage("source", Kind::Source, {}));
+
+  dspStage = new DspStage("dsp");
+  pipeline->addStage(dspStage);
+
+  displayDecimator = new DecimateStage("decimate");
+  pipeline->addStage(displayDecimator);
+
+  pipeline->addStage(new CallbackStage(
+      "traces", Kind::Display,
+      [this](const FrameBlock &b) { processTraceBlock(b); },
+      [this]() { renderScheduler->reset(); }));
+
+  pipeline->addStage(new CallbackStage(
+      "history", Kind::Analysis, [this](const FrameBlock &b) {
+        // Keine Ringplätze überschreiben, die Analyse-Jobs noch lesen
+        analyzer->reserveHistory(b.frameCount());
+        history->append(b.samples.constData(), b.frameCount(), b.channels);
+      }));
+
+  pipeline->addStage(new CallbackStage(
+      "fft", Kind::Analysis,
+      [this](const FrameBlock &b) { processFftBlock(b); },
+      [this]() {
+        analyzer->reset();
+        lastFftGeneration = 0;
+        lastMatrixGeneration = 0;
+        nextFftNs = 0;
+        nextBandPowerNs = 0;
+      }));
+
+  pipeline->addStage(new CallbackStage(
+      "spectrogram", Kind::Display,
+      [this](const FrameBlock &b) { processSpectrogramBlock(b); },
+      [this]() {
+        if (spectrogram)
+          spectrogram->clear();
+      }));
+
+  pipeline->addStage(new CallbackStage(
+      "bandtracker", Kind::Analysis,
+      [this](const FrameBlock &b) {
+        bandTracker->processBlock(b.samples.constData(), b.frameCount(),
+                                  b.channels);
+        trackerNewestArrivalNs = b.arrivalNs;
+      },
+      [this]() {
+        bandTracker->reset();
+        trackerNewestArrivalNs = -1;
+        lastPublishedArrivalNs = -1;
+        latencySumMs = latencyMaxMs = 0.0;
+        latencyCount = 0;
+      }));
+
+  pipeline->addStage(new CallbackStage(
+      "headmap", Kind::Analysis,
+      [this](const FrameBlock &b) { processHeadBlock(b); },
+      [this]() {
+        headRms->reset();
+        nextHeadNs = 0;
+      }));
+
+  pipeline->addStage(new CallbackStage(
+      "recorder", Kind::Recorder,
+      [this](const FrameBlock &b) { processRecorderBlock(b); }));
+
+  pipeline->connectStages("source", "dsp");
+  pipeline->connectStages("dsp", "decimate");
+  pipeline->connectStages("decimate", "traces");
+  pipeline->connectStages("dsp", "history");
+  pipeline->connectStages("history", "fft");
+  pipeline->connectStages("fft", "spectrogram");
+  pipeline->connectStages("dsp", "bandtracker");
+  pipeline->connectStages("dsp", "headmap");
+  pipeline->connectStages("dsp", "recorder");
+}
 
-    plot->graph(0)->addData(time, filtered[i]);
-    plot->graph(0)->data()->removeBefore(time - windowSec);
+void MainWindow::updatePipelineConfig() {
+  if (dspStage)
+    dspStage->setProcessor(dataProcessor);
 
-    if (doPlotUpdate) {
-      plot->xAxis->setRange(time - windowSec, time);
-      plot->graph(0)->rescaleValueAxis(false, true);
-      plot->replot(QCustomPlot::rpQueuedReplot);
-    }
-  }
-  if (doPlotUpdate) {
-    accumPlots = 0.0;
+  // Traces höchstens mit ~1 kHz zeichnen; Min/Max je Gruppe, damit kurze
+  // Spitzen auch ohne Bandpass erhalten bleiben
+  if (displayDecimator)
+    displayDecimator->setFactor(std::max(1, int(currentSampleRate / 1000.0)));
+
+  if (history && history->capacity() != historyCapacity()) {
+    analyzer->waitForJobs(); // Jobs lesen direkt aus dem Verlauf
+    history->configure(numChannels, historyCapacity());
+    analyzer->reset();
   }
+  if (analyzer)
+    analyzer->setSampleRate(currentSampleRate);
+  if (bandTracker)
+    bandTracker->updateSampleRate(currentSampleRate);
+  if (headRms)
+    headRms->updateSampleRate(currentSampleRate);
+  applySpectrogramConfig();
+}
 
-  // ---- Bandpower-Buffer (Average of all channels for Global Field Power) ----
-  if (!filtered.isEmpty()) {
-    double sum = 0.0;
-    for (double v : filtered) {
-      sum += v;
-    }
-    double avg = sum / double(filtered.size());
-    bandPowerBuffer.append(avg);
+int MainWindow::historyCapacity() const {
+  return std::max(1, int(std::ceil(historySeconds * currentSampleRate)));
+}
 
-    int maxSamples = int(currentSampleRate * windowSec);
-    // Erst aufräumen, wenn deutlich zu groß (Amortisierung)
-    if (bandPowerBuffer.size() > maxSamples * 1.5) {
-      bandPowerBuffer.remove(0, bandPowerBuffer.size() - maxSamples);
-    }
-  }
+void MainWindow::applySpectrogramConfig() {
+  if (!analyzer)
+    return;
 
-  // ---- FFT-Buffer & Head-Buffer für alle Kanäle ----
-  int maxSamples = int(currentSampleRate * windowSec);
-  int headMaxSamples = int(currentSampleRate * 2.0);
+  // 1 s Fenster, Hop = 1/16 Fenster (~16 Spalten/s), keine Mittelung:
+  // jede Spalte ist das Periodogramm eines Segments
+  WelchEstimator::Config cfg;
+  cfg.segmentSeconds = 1.0;
+  cfg.overlap = 1.0 - 1.0 / 16.0;
+  cfg.averages = 1;
+  const int ch = spectrogramChannelCombo
+                     ? spectrogramChannelCombo->currentData().toInt()
+                     : 0;
+  analyzer->setSpectrogram(cfg, ch);
+
+  if (spectrogram)
+    spectrogram->clear();
+}
 
-  for (int ch = 0; ch < numChannels && ch < filtered.size(); ++ch) {
-    // FFT
-    fftBuffers[ch].append(filtered[ch]);
-    if (fftBuffers[ch].size() > maxSamples * 1.5) {
-      fftBuffers[ch].remove(0, fftBuffers[ch].size() - maxSamples);
-    }
+void MainWindow::applyFftZoom() {
+  if (!analyzer)
+    return;
+  const bool on = fftZoomCheckBox && fftZoomCheckBox->isChecked();
+  const double range = fftRangeCombo ? fftRangeCombo->currentData().toDouble()
+                                     : 30.0;
+  analyzer->setZoom(on ? range : 0.0, fftZoomStepHz);
+  lastFftGeneration = 0;
+}
 
-    // Head-Plot RMS
-    headBuffers[ch].append(filtered[ch]);
-    if (headBuffers[ch].size() > headMaxSamples * 1.5) {
-      headBuffers[ch].remove(0, headBuffers[ch].size() - headMaxSamples);
-    }
-  }
+void MainWindow::applyWelchConfig() {
+  if (welchSegmentCombo)
+    welchConfig.segmentSeconds = welchSegmentCombo->currentData().toDouble();
+  if (welchOverlapCombo)
+    welchConfig.overlap = welchOverlapCombo->currentData().toDouble();
+  if (welchAveragesSpin)
+    welchConfig.averages = welchAveragesSpin->value();
 
-  static double accumBP = 0.0;
-  static double accumFft = 0.0;
-  static double accumHead = 0.0;
+  if (analyzer)
+    analyzer->setWelchConfig(welchConfig);
+}
 
-  accumBP += dt;
-  accumFft += dt;
-  accumHead += dt;
+void MainWindow::processTraceBlock(const FrameBlock &block) {
+  const int frames = block.frameCount();
 
-  // Bandpower + Theta/Beta: 1x pro Sekunde
-  if (accumBP > 1.0 && bandPowerBuffer.size() >= maxSamples) {
-    BandPower bp = computeBandPower(bandPowerBuffer, currentSampleRate);
-    updateBandPowerPlot(bp);
-    updateThetaBetaBarsFromBandPower(bp);
-    accumBP = 0.0;
+  // Nur Daten übernehmen; gezeichnet wird im Takt des RenderSchedulers
+  if (traceModeCombo->currentData().toInt() != TracePerChannel) {
+    montageView->appendFrames(block.samples.constData(), frames,
+                              block.channels, block.startTime, block.dt);
+  } else {
+    // Ring über das Fenster; Keys ergeben sich aus startTime + i * dt
+    const int capacity = int(std::ceil(traceWindowSeconds / block.dt)) + 1;
+    for (int i = 0; i < numChannels && i < block.channels; ++i) {
+      channelGraphs[i]->configure(block.dt, capacity);
+      channelGraphs[i]->addSamples(block.samples.constData() + i, frames,
+                                   block.channels, block.startTime);
+    }
   }
+  renderScheduler->markDirty(block.arrivalNs);
+}
 
-  // FFT: 1x pro Sekunde
-  bool fftReady = true;
-  for (int ch = 0; ch < numChannels; ++ch) {
-    if (fftBuffers[ch].size() < maxSamples) {
-      fftReady = false;
-      break;
-    }
+void MainWindow::renderTraces() {
+  // Synchron zeichnen, damit der Scheduler die Frame-Dauer misst
+  if (traceModeCombo->currentData().toInt() != TracePerChannel) {
+    montageView->repaint();
+    return;
   }
-  if (accumFft > 1.0 && fftReady) {
+  for (int i = 0; i < channelPlots.size(); ++i) {
+    StreamingGraph *graph = channelGraphs[i];
+    if (graph->isEmpty())
+      continue;
+    QCustomPlot *plot = channelPlots[i];
+    plot->xAxis->setRange(graph->lastKey() - traceWindowSeconds,
+                          graph->lastKey());
+    // Autoskala aus den mitgeführten Block-Extrema: O(Blöcke) statt Scan
+    // über das Fenster, ein kurzer Ausreißer staucht die Spur nicht
+    QCPRange range = graph->robustValueRange();
+    if (range.size() < 1e-9)
+      range = QCPRange(range.center() - 1.0, range.center() + 1.0);
+    plot->yAxis->setRange(range);
+    plot->replot(QCustomPlot::rpImmediateRefresh);
+  }
+}
+
+void MainWindow::processFftBlock(const FrameBlock &) {
+  // Welch + Matrix rechnet der Thread-Pool aus dem Verlauf; angezeigt wird
+  // im Bildtakt (refreshAnalysisViews)
+  analyzer->dispatch();
+}
+
+void MainWindow::processSpectrogramBlock(const FrameBlock &) {
+  if (!spectrogram)
+    return;
+
+  // Fertige Spalten abholen; das Widget zeichnet gedrosselt
+  double binHz = 0.0;
+  const QVector<QVector<double>> columns =
+      analyzer->takeSpectrogramColumns(&binHz);
+  for (const QVector<double> &psd : columns)
+    spectrogram->appendColumn(psd.constData(), psd.size(), binHz);
+}
+
+void MainWindow::processHeadBlock(const FrameBlock &block) {
+  headRms->processBlock(block.samples.constData(), block.frameCount(),
+                        block.channels);
+}
+
+void MainWindow::renderFrame() {
+  renderTraces();
+  refreshAnalysisViews();
+}
+
+void MainWindow::refreshAnalysisViews() {
+  // Nach Wanduhr statt nach Samples gedrosselt: Schübe und Pausen im
+  // Datenstrom ändern die Bildrate dieser Ansichten nicht
+  const qint64 now = latencyClock.nsecsElapsed();
+  const auto result = analyzer ? analyzer->spectrum() : nullptr;
+
+  // FFT-Plot und Bandpower: jüngstes veröffentlichtes Spektrum, 4 Hz
+  if (now >= nextFftNs && result && result->generation != lastFftGeneration) {
     updateFftPlot();
-    accumFft = 0.0;
+    lastFftGeneration = result->generation;
+    nextFftNs = now + 250000000LL;
+  }
+  if (now >= nextBandPowerNs && result &&
+      result->generation != lastMatrixGeneration) {
+    refreshBandPowerPlot();
+    lastMatrixGeneration = result->generation;
+    nextBandPowerNs = now + 250000000LL;
   }
 
-  // Head-Plot: 2x pro Sekunde
-  if (accumHead > 0.5) {
+  // Head-Plot: RMS mit ~30 Hz, Bandpower-Matrix 2x pro Sekunde
+  const int mode = headMapBandCombo ? headMapBandCombo->currentData().toInt()
+                                    : -1;
+  const bool rmsMode =
+      (mode == HeadMapRmsWindow || mode == HeadMapRmsExponential);
+  if (now >= nextHeadNs) {
     updateElectrodePlacement();
-    accumHead = 0.0;
+    nextHeadNs = now + (rmsMode ? 1000000000LL / 30 : 500000000LL);
   }
+}
 
-  time += dt;
+void MainWindow::processRecorderBlock(const FrameBlock &block) {
+  if (!isRecording)
+    return;
 
-  if (isRecording) {
-    // Write data to CSV: Index, Ch1, Ch2, ...
-    int numSamples = filtered.size() / numChannels;
-    for (int i = 0; i < numSamples; ++i) {
-      recordingStream << recordingIndex++ << ",";
-      for (int ch = 0; ch < numChannels; ++ch) {
-        recordingStream << filtered[i * numChannels + ch];
-        if (ch < numChannels - 1)
-          recordingStream << ",";
-      }
-      recordingStream << "\n";
+  // Write data to CSV: Index, Ch1, Ch2, ...
+  const int frames = block.frameCount();
+  for (int f = 0; f < frames; ++f) {
+    recordingStream << recordingIndex++ << ",";
+    for (int ch = 0; ch < block.channels; ++ch) {
+      recordingStream << block.value(f, ch);
+      if (ch < block.channels - 1)
+        recordingStream << ",";
     }
+    recordingStream << "\n";
+  }
+}
+
+void MainWindow::updatePipelineStats() {
+  if (!pipeline || !pipelineStatsLabel)
+    return;
+  const RenderScheduler::Stats frames = renderScheduler->takeStats();
+  pipelineStatsLabel->setText(
+      QString("Pipeline: %1 µs/block | Traces: %2 fps")
+          .arg(pipeline->totalAvgUs(), 0, 'f', 1)
+          .arg(frames.fps, 0, 'f', 0));
+  QString report = pipeline->statsReport();
+  report += QString("\nTrace frames: %1 fps (target %2), %3 ms avg / %4 ms "
+                    "max, %5 dropped, data-to-screen %6 ms avg / %7 ms max")
+                .arg(frames.fps, 0, 'f', 1)
+                .arg(frames.targetFps, 0, 'f', 1)
+                .arg(frames.avgFrameMs, 0, 'f', 2)
+                .arg(frames.maxFrameMs, 0, 'f', 2)
+                .arg(frames.dropped)
+                .arg(frames.avgLatencyMs, 0, 'f', 1)
+                .arg(frames.maxLatencyMs, 0, 'f', 1);
+  if (analyzer) {
+    report += QString("\nWorker: spectrum %1 µs, spectrogram %2 µs (last job)")
+                  .arg(analyzer->lastSpectrumJobUs(), 0, 'f', 0)
+                  .arg(analyzer->lastSpectrogramJobUs(), 0, 'f', 0);
+    const SpectralCache::Stats cache = analyzer->cacheStats();
+    report += QString("\nSpectral cache: %1 hits / %2 misses (%3 %), "
+                      "%4/%5 entries")
+                  .arg(cache.hits)
+                  .arg(cache.misses)
+                  .arg(100.0 * cache.hitRate(), 0, 'f', 1)
+                  .arg(cache.entries)
+                  .arg(cache.capacity);
   }
+  if (traceModeCombo->currentData().toInt() != TracePerChannel)
+    report += QString("\nMontage paint: %1 ms (%2 columns redrawn)")
+                  .arg(montageView->lastPaintMs(), 0, 'f', 2)
+                  .arg(montageView->lastDirtyColumns());
+  if (electrodePlacementScene)
+    report += QString("\nTopomap update: %1 µs at %2 px/unit")
+                  .arg(electrodePlacementScene->lastUpdateUs(), 0, 'f', 0)
+                  .arg(electrodePlacementScene->heatmapResolution(), 0, 'f',
+                       2);
+  pipelineStatsLabel->setToolTip(report);
 }
 
 bool MainWindow::startRecording() {
@@ -678,9 +1198,7 @@ bool MainWindow::startRecording() {
     recordingStream << "% Sample Rate = " << currentSampleRate << "\n";
     recordingStream << "% Created by NeuroEase GUI\n";
     recordingStream << "% File Path = " << userFile << "\n";
-    recordingStream
-        << "Index, Fp1, Fp2, F7, F8, Fz, Pz, T5, T6\n"; // Hardcoded labels for
-                                                        // now
+    recordingStream << "Index, " << eegChannelLabels().join(", ") << "\n";
 
     isRecording = true;
     recordingIndex = 0;
@@ -710,12 +1228,15 @@ void MainWindow::stopRecording() {
 
 void MainWindow::resetPlots() {
   time = 0.0;
+  sampleCounter = 0;
 
+  if (montageView)
+    montageView->clear();
+
+  for (StreamingGraph *graph : std::as_const(channelGraphs))
+    graph->clear();
   for (auto *plot : channelPlots) {
-    if (!plot || plot->graphCount() == 0)
-      continue;
-    plot->graph(0)->data()->clear();
-    plot->xAxis->setRange(0, 3);
+    plot->xAxis->setRange(0, traceWindowSeconds);
     plot->replot();
   }
 
@@ -727,11 +1248,13 @@ void MainWindow::resetPlots() {
     thetaBetaBarPlot->replot();
 
   placementConfirmed = false;
-  bandPowerBuffer.clear();
-  for (auto &buf : fftBuffers)
-    buf.clear();
-  for (auto &buf : headBuffers)
-    buf.clear();
+
+  // Puffer, Drossel-Zähler und Queues aller Stufen
+  pendingSamples.clear();
+  if (pipeline) {
+    pipeline->reset();
+    pipeline->resetStats();
+  }
 
   if (dataProcessor)
     dataProcessor->reset();
@@ -744,29 +1267,33 @@ void MainWindow::resetPlots() {
 }
 
 // -----------------------------------------------------------------------------
-// Elektroden-Heatmap (RMS-Aktivität aus headBuffers)
+// Elektroden-Heatmap (Amplitude je Kanal aus Bandpower-Matrix oder RMS)
 // -----------------------------------------------------------------------------
 
 void MainWindow::updateElectrodePlacement() {
-  if (!electrodePlacementScene || headBuffers.isEmpty())
+  if (!electrodePlacementScene || !analyzer)
     return;
 
-  // Aktivitäten extrahieren
   QVector<double> activities(numChannels, 0.0);
-  double maxAct = 0.0;
-  for (int ch = 0; ch < numChannels; ++ch) {
-    const auto &buf = headBuffers[ch];
-    if (buf.isEmpty())
-      continue;
-    double sumSq = 0.0;
-    for (double v : buf)
-      sumSq += v * v;
-    double rms = std::sqrt(sumSq / double(buf.size()));
-    activities[ch] = rms;
-    if (rms > maxAct)
-      maxAct = rms;
+  const int band = headMapBandCombo ? headMapBandCombo->currentData().toInt()
+                                    : -1;
+  if (band == HeadMapRmsWindow || band == HeadMapRmsExponential) {
+    activities = headRms->rmsAll(); // bereits µV
+  } else {
+    const auto result = analyzer->spectrum();
+    if (result && result->bands.isValid())
+      activities = (band >= 0) ? result->bands.bandTopography(band)
+                               : result->bands.totalPowers();
+
+    // µV² -> µV (RMS im Band)
+    for (double &a : activities)
+      a = std::sqrt(std::max(0.0, a));
   }
 
+  double maxAct = 0.0;
+  for (double a : activities)
+    maxAct = std::max(maxAct, a);
+
   // Normalisierung
   if (maxAct > 0.0) {
     for (double &a : activities)
@@ -775,6 +1302,18 @@ void MainWindow::updateElectrodePlacement() {
 
   // Nutze die spezialisierte Klasse für das Zeichnen
   electrodePlacementScene->setActivities(activities);
+
+  const int measure =
+      connectivityCombo ? connectivityCombo->currentData().toInt() : -1;
+  const auto result = measure >= 0 ? analyzer->spectrum() : nullptr;
+  if (result && result->connectivity.isValid()) {
+    electrodePlacementScene->setConnections(
+        result->connectivity.matrix(
+            ConnectivityEstimator::Measure(measure), std::max(band, -1)),
+        result->connectivity.channelCount());
+  } else {
+    electrodePlacementScene->clearConnections();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -850,120 +1389,56 @@ void MainWindow::updateFocusIndicator(double ratio) {
 }
 
 // -----------------------------------------------------------------------------
-// Magnitude-Spektrum (für BandPower & FFT)
-// -----------------------------------------------------------------------------
-
+// Neurofeedback (Sliding-DFT-Tracker, 30 Hz) inkl. Latenzmessung
 // -----------------------------------------------------------------------------
-// FFT-Algorithmus (Radix-2)
-// -----------------------------------------------------------------------------
-
-void MainWindow::fft(QVector<std::complex<double>> &a, bool invert) {
-  int n = a.size();
-  for (int i = 1, j = 0; i < n; i++) {
-    int bit = n >> 1;
-    for (; j & bit; bit >>= 1)
-      j ^= bit;
-    j ^= bit;
-    if (i < j)
-      std::swap(a[i], a[j]);
-  }
-  for (int len = 2; len <= n; len <<= 1) {
-    double ang = 2 * M_PI / len * (invert ? -1 : 1);
-    std::complex<double> wlen(std::cos(ang), std::sin(ang));
-    for (int i = 0; i < n; i += len) {
-      std::complex<double> w(1);
-      for (int j = 0; j < len / 2; j++) {
-        std::complex<double> u = a[i + j], v = a[i + j + len / 2] * w;
-        a[i + j] = u + v;
-        a[i + j + len / 2] = u - v;
-        w *= wlen;
-      }
-    }
-  }
-  if (invert) {
-    for (auto &x : a)
-      x /= n;
-  }
-}
-
-QVector<double>
-MainWindow::computeMagnitudeSpectrum(const QVector<double> &signal,
-                                     double sampleRate) {
-  int Ntotal = signal.size();
-  if (Ntotal < 32 || sampleRate <= 0.0)
-    return {};
-
-  // FFT braucht Power-of-2.
-  const int N = 1024;
-  QVector<std::complex<double>> fa(N);
-  int start = std::max(0, Ntotal - N);
-  int actualN = std::min(Ntotal, N);
-
-  // DC-Entfernung & Fensterung
-  double mean = 0.0;
-  for (int n = 0; n < actualN; ++n)
-    mean += signal[start + n];
-  mean /= double(actualN);
-
-  for (int i = 0; i < N; i++) {
-    if (i < actualN) {
-      double w = 0.5 * (1.0 - std::cos(2.0 * M_PI * i / (actualN - 1)));
-      fa[i] = std::complex<double>((signal[start + i] - mean) * w, 0);
-    } else {
-      fa[i] = std::complex<double>(0, 0);
-    }
-  }
 
-  fft(fa, false);
+void MainWindow::publishNeurofeedback() {
+  if (!bandTracker || !bandTracker->isReady())
+    return;
+  if (trackerNewestArrivalNs < 0 ||
+      trackerNewestArrivalNs == lastPublishedArrivalNs)
+    return; // keine neuen Samples seit dem letzten Update
 
-  int K = N / 2;
-  QVector<double> magSpec(K);
-  for (int k = 0; k < K; ++k) {
-    magSpec[k] = std::abs(fa[k]) / double(N);
+  // Kanalmittel der Bänder (Reihenfolge wie BandPowerTracker::defaultBands)
+  const QVector<double> p = bandTracker->bandPowers(-1);
+  if (p.size() < 5)
+    return;
+  updateThetaBetaBarsFromBandPower(BandPower{p[0], p[1], p[2], p[3], p[4]});
+
+  // Latenz: Eingang des jüngsten enthaltenen Samples -> Indikator gesetzt
+  const double ms =
+      double(latencyClock.nsecsElapsed() - trackerNewestArrivalNs) / 1e6;
+  lastPublishedArrivalNs = trackerNewestArrivalNs;
+  latencySumMs += ms;
+  latencyMaxMs = std::max(latencyMaxMs, ms);
+  ++latencyCount;
+
+  // Anzeige 1x pro Sekunde (Mittel/Max über die letzten ~30 Updates)
+  if (latencyCount >= 30) {
+    if (latencyLabel)
+      latencyLabel->setText(QString("Latency: %1 ms (max %2 ms)")
+                                .arg(latencySumMs / latencyCount, 0, 'f', 1)
+                                .arg(latencyMaxMs, 0, 'f', 1));
+    latencySumMs = latencyMaxMs = 0.0;
+    latencyCount = 0;
   }
-
-  return magSpec;
 }
 
 // -----------------------------------------------------------------------------
-// Bandpower-Berechnung (nutzt Magnitude-Spektrum)
+// Bandpower-Plot aus der Matrix (gewählter Kanal oder Kanalmittel)
 // -----------------------------------------------------------------------------
 
-MainWindow::BandPower
-MainWindow::computeBandPower(const QVector<double> &signal, double sampleRate) {
-  BandPower bp{0, 0, 0, 0, 0};
-
-  int N = signal.size();
-  if (N < 32 || sampleRate <= 0.0)
-    return bp;
-
-  QVector<double> mag = computeMagnitudeSpectrum(signal, sampleRate);
-  if (mag.isEmpty())
-    return bp;
-
-  int K = mag.size();
-  double hzPerBin = sampleRate / double(2 * K);
-
-  auto band = [&](double fLow, double fHigh) {
-    double sum = 0.0;
-    int iLow = int(std::floor(fLow / hzPerBin));
-    int iHigh = int(std::ceil(fHigh / hzPerBin));
-    iLow = std::max(iLow, 0);
-    iHigh = std::min(iHigh, K - 1);
-    for (int i = iLow; i <= iHigh; ++i) {
-      double a = mag[i];
-      sum += a * a; // Power ~ Amplitude^2
-    }
-    return sum;
-  };
-
-  bp.delta = band(0.5, 4.0);
-  bp.theta = band(4.0, 8.0);
-  bp.alpha = band(8.0, 13.0);
-  bp.beta = band(13.0, 32.0);
-  bp.gamma = band(32.0, 100.0);
+void MainWindow::refreshBandPowerPlot() {
+  const auto result = analyzer ? analyzer->spectrum() : nullptr;
+  if (!result || !result->bands.isValid())
+    return;
 
-  return bp;
+  const int ch =
+      bandPowerChannelCombo ? bandPowerChannelCombo->currentData().toInt() : -1;
+  const QVector<double> p = result->bands.channelPowers(ch);
+  if (p.size() < 5)
+    return;
+  updateBandPowerPlot(BandPower{p[0], p[1], p[2], p[3], p[4]});
 }
 
 // -----------------------------------------------------------------------------
@@ -1004,49 +1479,39 @@ void MainWindow::updateFftPlot() {
   if (!fftPlot || currentSampleRate <= 0.0)
     return;
 
-  if (fftBuffers.isEmpty())
-    return;
+  // Jüngstes Ergebnis aus dem Thread-Pool (unveränderlicher Schnappschuss)
+  const auto result = analyzer ? analyzer->spectrum() : nullptr;
 
-  int N = fftBuffers[0].size();
-  if (N < 32)
-    return;
-
-  // Frequenzachse nach FFT-Größe (fest 1024)
-  const int FFT_N = 1024;
-  int K = FFT_N / 2;
-  double hzPerBin = currentSampleRate / double(FFT_N);
-
-  QVector<double> freqs(K);
-  for (int k = 0; k < K; ++k)
-    freqs[k] = k * hzPerBin;
-
-  QList<QColor> colors = {Qt::red,  Qt::green,      Qt::blue,    Qt::magenta,
-                          Qt::cyan, Qt::darkYellow, Qt::darkRed, Qt::gray};
+  // Zoom-Spektrum, sobald es vorliegt; bis dahin das normale
+  const bool zoom = result && fftZoomCheckBox &&
+                    fftZoomCheckBox->isChecked() && !result->zoomPsd.isEmpty();
+  const QVector<QVector<double>> *spectra =
+      result ? (zoom ? &result->zoomPsd : &result->psd) : nullptr;
 
   double globalMax = 0.0;
 
   for (int ch = 0; ch < numChannels; ++ch) {
-    const auto &buf = fftBuffers[ch];
-    if (buf.size() < N)
+    if (fftPlot->graphCount() <= ch)
       continue;
-
-    QVector<double> spec = computeMagnitudeSpectrum(buf, currentSampleRate);
-    if (spec.isEmpty())
+    if (!spectra || ch >= spectra->size()) {
+      fftPlot->graph(ch)->data()->clear();
       continue;
-
-    int len = std::min(K, int(spec.size()));
-
-    QVector<double> f(len), a(len);
-    for (int i = 0; i < len; ++i) {
-      f[i] = freqs[i];
-      a[i] = spec[i];
-      if (a[i] > globalMax)
-        globalMax = a[i];
     }
 
-    if (fftPlot->graphCount() > ch) {
-      fftPlot->graph(ch)->setData(f, a);
+    // Amplitudendichte sqrt(PSD), DC-Bin weglassen
+    const QVector<double> &psd = (*spectra)[ch];
+    const double hzPerBin = zoom ? result->zoomBinHz : result->binHz;
+    const int len = psd.size();
+
+    QVector<double> f(len - 1), a(len - 1);
+    for (int k = 1; k < len; ++k) {
+      f[k - 1] = k * hzPerBin;
+      a[k - 1] = std::sqrt(psd[k]);
+      if (a[k - 1] > globalMax)
+        globalMax = a[k - 1];
     }
+
+    fftPlot->graph(ch)->setData(f, a, true);
   }
 
   if (globalMax <= 0.0)
@@ -1143,6 +1608,7 @@ void MainWindow::setSps(const QString &text) {
     dataProcessor =
         new DataProcessingQt(numChannels, currentSampleRate, hp, notch, bp);
   }
+  updatePipelineConfig();
 }
 
 void MainWindow::setGain(const QString &text) {
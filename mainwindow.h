@@ -8,20 +8,26 @@
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QVector>
-#include <complex>
 
 class QComboBox;
 class QSpinBox;
 class QCheckBox;
 class QCustomPlot;
 class QCPBars;
+class QTimer;
 class ZoomableGraphicsView;
 #include "AbstractDataSource.h"
+#include "WelchEstimator.h"
 #include <QCheckBox>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QTextStream>
 
 class DataProcessingQt;
+class ProcessingPipeline;
+class DspStage;
+class DecimateStage;
+struct FrameBlock;
 
 class MainWindow : public QMainWindow {
   Q_OBJECT
@@ -65,19 +71,53 @@ private:
   void updateThetaBetaBars(); // Default Balken
   void updateThetaBetaBarsFromBandPower(const BandPower &bp);
   void updateFocusIndicator(double ratio);
+  void publishNeurofeedback();
 
-  BandPower computeBandPower(const QVector<double> &signal, double sampleRate);
-  QVector<double> computeMagnitudeSpectrum(const QVector<double> &signal,
-                                           double sampleRate);
   void updateBandPowerPlot(const BandPower &bp);
+  void refreshBandPowerPlot();
   void updateFftPlot();
 
+  // Verarbeitungsgraph (source -> dsp -> Analyse-/Anzeige-Senken)
+  void buildPipeline();
+  void updatePipelineConfig();
+  void applyWelchConfig();
+  void applyFftZoom();
+  void updatePipelineStats();
+  void processTraceBlock(const FrameBlock &block);
+  void renderTraces();
+  /// Ein Frame des RenderSchedulers: Spuren, dann FFT/Bandpower/Head-Plot
+  void renderFrame();
+  void refreshAnalysisViews();
+  void processFftBlock(const FrameBlock &block);
+  void processSpectrogramBlock(const FrameBlock &block);
+  void applySpectrogramConfig();
+  void processHeadBlock(const FrameBlock &block);
+  void processRecorderBlock(const FrameBlock &block);
+  int historyCapacity() const;
+
   // Zeitachse
   double time = 0.0;
+  qint64 sampleCounter = 0;
+
+  // Noch nicht an die Pipeline gegebene Frames (ein Block je Durchlauf)
+  void flushPipeline();
+  QVector<double> pendingSamples; // interleaved, numChannels je Frame
+  double pendingStartTime = 0.0;
+  double pendingDt = 0.0;
+  qint64 pendingFirstIndex = 0;
+  qint64 pendingArrivalNs = 0;
+  bool flushScheduled = false;
 
   // EEG-Kanäle
   static constexpr int numChannels = 8;
+  static constexpr double traceWindowSeconds = 3.0;
   QVector<QCustomPlot *> channelPlots;
+  QVector<class StreamingGraph *> channelGraphs; // Ringpuffer je Plot
+  // Alle Kanäle gestapelt in einem Widget (Standard, laufend oder als Sweep)
+  // oder je Kanal ein Plot
+  enum TraceMode { TraceMontage = 0, TracePerChannel = 1, TraceSweep = 2 };
+  QComboBox *traceModeCombo = nullptr;
+  class EegMontageView *montageView = nullptr;
   QVector<double> channelPhases;
 
   // Buttons
@@ -85,6 +125,7 @@ private:
   QPushButton *stopButton = nullptr;
   QPushButton *resetButton = nullptr;
   QPushButton *impedanceButton = nullptr;
+  QPushButton *liveImpedanceButton = nullptr;
 
   // Layouts
   QHBoxLayout *mainHorizontalLayout = nullptr;
@@ -106,14 +147,55 @@ private:
   QCustomPlot *bandPowerPlot = nullptr;
   QVector<QCPBars *> bandPowerBarsList;
   QVector<double> bandPowerTicks;
+  QComboBox *bandPowerChannelCombo = nullptr; // -1 = Kanalmittel
+
+  // Bandpower-Plot + Topomaps aus der Matrix des jüngsten Spektrums
+  quint64 lastMatrixGeneration = 0;
+  QComboBox *headMapBandCombo = nullptr; // -1 = Gesamtleistung
+
+  // Head-Map aus dem laufenden RMS statt aus der Matrix
+  enum { HeadMapRmsWindow = -2, HeadMapRmsExponential = -3 };
+  class RunningRms *headRms = nullptr;
+
+  // Kanten auf der Head-Map: -1 = aus, sonst ConnectivityEstimator::Measure
+  QComboBox *connectivityCombo = nullptr;
 
   // FFT-Plot (unten, über Mitte+Rechts)
   QCustomPlot *fftPlot = nullptr;
-  QVector<QVector<double>> fftBuffers; // [channel][samples]
+  // Zoom-FFT (Chirp-Z) über den gewählten Bereich
+  static constexpr double fftZoomStepHz = 0.05;
+  QCheckBox *fftZoomCheckBox = nullptr;
+
+  // Gemeinsamer Kanalverlauf (Ring, monotoner Sample-Index)
+  static constexpr double historySeconds = 10.0;
+  class SampleHistory *history = nullptr;
+
+  // Welch-PSD pro Kanal + Bandpower-Matrix + Spektrogramm im Thread-Pool
+  class SpectralAnalyzer *analyzer = nullptr;
+  WelchEstimator::Config welchConfig{1024, 0.75, 8};
+  quint64 lastFftGeneration = 0;
+  QComboBox *welchSegmentCombo = nullptr;
+  QComboBox *welchOverlapCombo = nullptr;
+  QSpinBox *welchAveragesSpin = nullptr;
+
+  // Spektrogramm (ein Kanal, eigener Welch ohne Mittelung, ~16 Spalten/s)
+  class SpectrogramWidget *spectrogram = nullptr;
+  QComboBox *spectrogramChannelCombo = nullptr;
 
   // Fokus-Ampel
   QLabel *focusIndicator = nullptr;
 
+  // Neurofeedback: Sliding-DFT-Bandleistung, Update mit 30 Hz
+  class BandPowerTracker *bandTracker = nullptr;
+  QTimer *feedbackTimer = nullptr;
+  QLabel *latencyLabel = nullptr;
+  QElapsedTimer latencyClock;
+  qint64 trackerNewestArrivalNs = -1;
+  qint64 lastPublishedArrivalNs = -1;
+  double latencySumMs = 0.0;
+  double latencyMaxMs = 0.0;
+  int latencyCount = 0;
+
   // Aktuelle Datenquelle (Sim / Real / File)
   AbstractDataSource *dataSource = nullptr;
 
@@ -140,17 +222,22 @@ private:
   // Kontroll-Flag für Elektroden-Check
   bool placementConfirmed = false;
 
-  // Buffer für Bandpower (z.B. Kanal Fp1)
-  QVector<double> bandPowerBuffer;
-
-  // Buffer für Head-Plot (RMS-Aktivität pro Kanal)
-  QVector<QVector<double>> headBuffers;
-
   // DSP (Highpass + Notch + Bandlimit)
   DataProcessingQt *dataProcessor = nullptr;
 
-  // FFT Optimization
-  void fft(QVector<std::complex<double>> &a, bool invert);
+  // Pipeline + Stufen (Besitz liegt bei der Pipeline)
+  ProcessingPipeline *pipeline = nullptr;
+  DspStage *dspStage = nullptr;
+  DecimateStage *displayDecimator = nullptr;
+  QLabel *pipelineStatsLabel = nullptr;
+
+  // Bildtakt der Live-Ansichten (Wanduhr, unabhängig von der Datenrate)
+  class RenderScheduler *renderScheduler = nullptr;
+
+  // Nächste Aktualisierung der Analyse-Ansichten (latencyClock, ns)
+  qint64 nextBandPowerNs = 0;
+  qint64 nextFftNs = 0;
+  qint64 nextHeadNs = 0;
 };
 
 #endif // MAINWINDOW_H
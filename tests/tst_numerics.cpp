@@ -0,0 +1,251 @@
+#include "ChirpZ.h"
+#include "FftPlan.h"
+#include "TopoHeatmap.h"
+
+#include <QPointF>
+#include <QVector>
+#include <QtMath>
+#include <QtTest>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+
+// Numerische Kerne gegen direkte Referenzrechnungen: Legendre-Rekursion
+// und Spline-Gewichte der Topographie, Mixed-Radix-FFT und Chirp-Z.
+
+namespace {
+
+using Complex = std::complex<double>;
+
+QVector<double> randomSignal(int n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::normal_distribution<double> dist;
+  QVector<double> x(n);
+  for (double &v : x)
+    v = dist(gen);
+  return x;
+}
+
+// Direkte DFT; Winkel über (k n) mod N, damit die Referenz selbst genau ist
+QVector<Complex> naiveDft(const QVector<Complex> &x) {
+  const int n = int(x.size());
+  QVector<Complex> out(n);
+  for (int k = 0; k < n; ++k) {
+    Complex sum = 0.0;
+    for (int j = 0; j < n; ++j) {
+      const double angle =
+          -2.0 * M_PI * double((qint64(k) * j) % n) / double(n);
+      sum += x[j] * Complex(std::cos(angle), std::sin(angle));
+    }
+    out[k] = sum;
+  }
+  return out;
+}
+
+// DTFT an beliebiger Frequenz (Referenz für Chirp-Z)
+Complex directDtft(const QVector<double> &x, double hz, double sampleRate) {
+  Complex sum = 0.0;
+  for (int j = 0; j < x.size(); ++j) {
+    const double angle = -2.0 * M_PI * hz * j / sampleRate;
+    sum += x[j] * Complex(std::cos(angle), std::sin(angle));
+  }
+  return sum;
+}
+
+// 8 Kanäle des 10-20-Systems auf ganze Szenenkoordinaten gerundet, damit
+// jede Elektrode genau auf einem Pixel der Stufe 1 px/Einheit liegt
+TopoHeatmap::LevelSpec tenTwentySpec(TopoHeatmap::Method method) {
+  const double headR = 80.0;
+  const double tenTwenty[][2] = {{72, -18}, {72, 18},   {72, -54},
+                                 {72, 54},  {36, 0},    {36, 180},
+                                 {72, -126}, {72, 126}};
+  TopoHeatmap::LevelSpec spec;
+  for (const auto &p : tenTwenty) {
+    const QPointF pos = TopoHeatmap::projectTenTwenty(p[0], p[1], headR);
+    spec.positions.append(QPointF(qRound(pos.x()), qRound(pos.y())));
+  }
+  spec.electrodes = int(spec.positions.size());
+  spec.headRadius = headR;
+  spec.width = 300;
+  spec.height = 300;
+  spec.method = method;
+  return spec;
+}
+
+} // namespace
+
+class TestNumerics : public QObject {
+  Q_OBJECT
+
+private slots:
+  void legendreKnownValues();
+  void splineReproducesElectrodes();
+  void weightsSumToOne();
+  void fftRealMixedRadix();
+  void fftComplexMixedRadix();
+  void chirpZTransform();
+  void chirpZPowerPair();
+};
+
+void TestNumerics::legendreKnownValues() {
+  struct {
+    int n;
+    double x, expected;
+  } const cases[] = {{0, 0.3, 1.0},    {1, -0.7, -0.7},  {2, 0.0, -0.5},
+                     {2, 0.5, -0.125}, {3, 0.5, -0.4375}, {4, 0.0, 0.375},
+                     {4, 1.0, 1.0},    {5, -1.0, -1.0}};
+  for (const auto &c : cases)
+    QVERIFY2(std::abs(TopoHeatmap::legendre(c.n, c.x) - c.expected) < 1e-12,
+             qPrintable(QString("P%1(%2)").arg(c.n).arg(c.x)));
+
+  // Geschlossene Form P3(x) = (5x^3 - 3x) / 2 über das ganze Intervall
+  for (double x = -1.0; x <= 1.0; x += 0.125)
+    QVERIFY(std::abs(TopoHeatmap::legendre(3, x) -
+                     0.5 * (5.0 * x * x * x - 3.0 * x)) < 1e-12);
+}
+
+void TestNumerics::splineReproducesElectrodes() {
+  const TopoHeatmap::LevelSpec spec =
+      tenTwentySpec(TopoHeatmap::SphericalSpline);
+  const TopoHeatmap::Level level = TopoHeatmap::buildLevel(spec);
+  const int stride = level.image.bytesPerLine() / int(sizeof(QRgb));
+
+  // Am Pixel der Elektrode e ist das Gewicht von e gleich 1, alle anderen 0
+  for (int e = 0; e < spec.electrodes; ++e) {
+    const int x = int(spec.positions[e].x()) + spec.width / 2;
+    const int y = int(spec.positions[e].y()) + spec.height / 2;
+    const int p = int(level.pixels.indexOf(y * stride + x));
+    QVERIFY2(p >= 0, qPrintable(QString("electrode %1 outside mask").arg(e)));
+    for (int k = 0; k < spec.electrodes; ++k) {
+      const double w = level.weights[k * level.stride + p];
+      QVERIFY2(std::abs(w - (k == e ? 1.0 : 0.0)) < 1e-3,
+               qPrintable(QString("w_%1 at electrode %2 = %3")
+                              .arg(k)
+                              .arg(e)
+                              .arg(w)));
+    }
+  }
+}
+
+void TestNumerics::weightsSumToOne() {
+  for (TopoHeatmap::Method method :
+       {TopoHeatmap::SphericalSpline, TopoHeatmap::InverseDistance}) {
+    const TopoHeatmap::LevelSpec spec = tenTwentySpec(method);
+    const TopoHeatmap::Level level = TopoHeatmap::buildLevel(spec);
+    QVERIFY(!level.pixels.isEmpty());
+
+    double maxErr = 0.0;
+    for (int p = 0; p < level.pixels.size(); ++p) {
+      double sum = 0.0;
+      for (int e = 0; e < spec.electrodes; ++e)
+        sum += level.weights[e * level.stride + p];
+      maxErr = std::max(maxErr, std::abs(sum - 1.0));
+    }
+    QVERIFY2(maxErr < 1e-4,
+             qPrintable(QString("method %1: max |sum - 1| = %2")
+                            .arg(int(method))
+                            .arg(maxErr)));
+  }
+}
+
+void TestNumerics::fftRealMixedRadix() {
+  for (int n : {750, 6000}) {
+    QVERIFY(FftPlan::isSupportedSize(n));
+    const QVector<double> x = randomSignal(n, unsigned(n));
+    QVector<Complex> ref(n);
+    for (int j = 0; j < n; ++j)
+      ref[j] = x[j];
+    ref = naiveDft(ref);
+
+    auto plan = FftPlan::forSize(n);
+    QVector<Complex> out(plan->bins());
+    plan->forwardReal(x.constData(), out.data());
+
+    double maxErr = 0.0;
+    for (int k = 0; k < plan->bins(); ++k)
+      maxErr = std::max(maxErr, std::abs(out[k] - ref[k]));
+    QVERIFY2(maxErr < 1e-9 * n,
+             qPrintable(QString("N = %1: max error %2").arg(n).arg(maxErr)));
+  }
+}
+
+void TestNumerics::fftComplexMixedRadix() {
+  for (int n : {750, 6000}) {
+    const int m = n / 2; // komplexe Länge des Plans
+    const QVector<double> re = randomSignal(m, unsigned(n) + 1);
+    const QVector<double> im = randomSignal(m, unsigned(n) + 2);
+    QVector<Complex> x(m);
+    for (int j = 0; j < m; ++j)
+      x[j] = Complex(re[j], im[j]);
+    const QVector<Complex> ref = naiveDft(x);
+
+    auto plan = FftPlan::forSize(n);
+    QVector<Complex> out(m);
+    plan->forwardComplex(x.constData(), out.data());
+
+    double maxErr = 0.0;
+    for (int k = 0; k < m; ++k)
+      maxErr = std::max(maxErr, std::abs(out[k] - ref[k]));
+    QVERIFY2(maxErr < 1e-9 * m,
+             qPrintable(QString("N/2 = %1: max error %2").arg(m).arg(maxErr)));
+  }
+}
+
+void TestNumerics::chirpZTransform() {
+  // Zoom-Raster wie in der Anwendung (0,05 Hz) und ein versetztes Raster
+  struct {
+    int n;
+    double fs, startHz, stepHz;
+    int points;
+  } const cases[] = {{750, 250.0, 0.0, 0.05, 601}, {100, 250.0, 3.3, 0.7, 40}};
+  for (const auto &c : cases) {
+    const QVector<double> x = randomSignal(2 * c.n, unsigned(c.n));
+    QVector<double> channel(c.n); // jedes zweite Sample (stride 2)
+    for (int j = 0; j < c.n; ++j)
+      channel[j] = x[2 * j + 1];
+
+    auto cz = ChirpZ::forSpec(c.n, c.fs, c.startHz, c.stepHz, c.points);
+    ChirpZWorkspace ws;
+    QVector<Complex> out(c.points);
+    cz->transform(x.constData() + 1, 2, ws, out.data());
+
+    double maxErr = 0.0;
+    for (int m = 0; m < c.points; ++m) {
+      const Complex ref =
+          directDtft(channel, c.startHz + m * c.stepHz, c.fs);
+      maxErr = std::max(maxErr, std::abs(out[m] - ref));
+    }
+    QVERIFY2(maxErr < 1e-8 * c.n,
+             qPrintable(QString("N = %1: max error %2").arg(c.n).arg(maxErr)));
+  }
+}
+
+void TestNumerics::chirpZPowerPair() {
+  const int n = 750;
+  const double fs = 250.0;
+  const double step = 0.05;
+  const int half = 601;
+  const QVector<double> a = randomSignal(n, 11);
+  const QVector<double> b = randomSignal(n, 12);
+
+  auto cz = ChirpZ::symmetric(n, fs, step, half);
+  ChirpZWorkspace ws;
+  QVector<double> p1(half), p2(half), single(half);
+  cz->powerPair(a.constData(), b.constData(), 1, ws, p1.data(), p2.data());
+  cz->powerPair(b.constData(), nullptr, 1, ws, single.data(), nullptr);
+
+  double maxRel = 0.0;
+  for (int m = 0; m < half; ++m) {
+    const double ra = std::norm(directDtft(a, m * step, fs));
+    const double rb = std::norm(directDtft(b, m * step, fs));
+    maxRel = std::max({maxRel, std::abs(p1[m] - ra) / std::max(1.0, ra),
+                       std::abs(p2[m] - rb) / std::max(1.0, rb),
+                       std::abs(single[m] - rb) / std::max(1.0, rb)});
+  }
+  QVERIFY2(maxRel < 1e-8,
+           qPrintable(QString("max relative error %1").arg(maxRel)));
+}
+
+QTEST_GUILESS_MAIN(TestNumerics)
+#include "tst_numerics.moc"
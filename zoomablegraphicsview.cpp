@@ -1,4 +1,5 @@
 #include "zoomablegraphicsview.h"
+#include <QStyleOptionGraphicsItem>
 #include <QTransform>
 #include <QtMath>
 
@@ -47,4 +48,18 @@ void ZoomableGraphicsView::wheelEvent(QWheelEvent *event)
 
     // Ereignis als verarbeitet markieren, damit es nicht an den Parent weitergeleitet wird
     event->accept();
+    emit resolutionChanged(pixelsPerUnit());
+}
+
+void ZoomableGraphicsView::showEvent(QShowEvent *event)
+{
+    QGraphicsView::showEvent(event);
+    // Geräte-Pixelverhältnis steht erst mit dem Fenster fest
+    emit resolutionChanged(pixelsPerUnit());
+}
+
+double ZoomableGraphicsView::pixelsPerUnit() const
+{
+    return QStyleOptionGraphicsItem::levelOfDetailFromTransform(transform())
+           * devicePixelRatioF();
 }
@@ -12,8 +12,16 @@ public:
     explicit ZoomableGraphicsView(QWidget *parent = nullptr); // KORREKTUR: Richtiger Konstruktorname und Parameter
     // ~ZoomableGraphicsView() override; // Wenn ein benutzerdefinierter Destruktor nötig wäre
 
+    // Pixel je Szeneneinheit (Zoom mal Geräte-Pixelverhältnis)
+    double pixelsPerUnit() const;
+
+signals:
+    // Nach jeder Änderung des Maßstabs (Zoom) und beim ersten Anzeigen
+    void resolutionChanged(double pixelsPerUnit);
+
 protected:
     void wheelEvent(QWheelEvent *event) override; // Deklaration der überschriebenen Methode
+    void showEvent(QShowEvent *event) override;
 };
 
 #endif // ZOOMABLEGRAPHVIEW_H